@@ -0,0 +1,23 @@
+// Generated by native/level_compiler.c, do not edit
+#ifndef LEVELS_H_
+#define LEVELS_H_
+
+#include <stdint.h>
+
+#define NUM_LEVELS      8
+#define LEVEL_PACK_SIZE 52
+
+// Where each level starts in level_pack
+static const uint16_t level_pack_offsets[NUM_LEVELS] = {
+    0, 5, 10, 17, 24, 31, 38, 45,
+};
+
+static const uint8_t level_pack[LEVEL_PACK_SIZE] = {
+    0x03, 0x04, 0x0b, 0x30, 0x00, 0x03, 0x04, 0x13, 0x30, 0x00, 0x04, 0x05,
+    0x00, 0x69, 0x1b, 0x30, 0x00, 0x04, 0x05, 0x00, 0x69, 0x23, 0x30, 0x00,
+    0x04, 0x06, 0x00, 0x2d, 0x2b, 0x30, 0x00, 0x05, 0x06, 0x00, 0x2d, 0x33,
+    0x30, 0x00, 0x05, 0x07, 0x00, 0x4b, 0x3b, 0x30, 0x00, 0x05, 0x07, 0x00,
+    0x4b, 0x43, 0x30, 0x00,
+};
+
+#endif
@@ -0,0 +1,329 @@
+// Generated by native/gen_sprites.c, do not edit
+#ifndef SPRITES_H_
+#define SPRITES_H_
+
+#include <stdint.h>
+
+#define SPRITE_DRAW_COLORS   0x4320
+#define SPRITE_FLAGS         BLIT_2BPP
+
+#define BRICK_ATLAS_WIDTH    160
+#define BRICK_ATLAS_HEIGHT   90
+#define BALL_STRIP_WIDTH     44
+#define BALL_STRIP_HEIGHT    4
+#define NUM_BALL_STRIP_CELLS 8
+
+// Bricks of health h are in rows [(h - 1) * BRICK_HEIGHT, h * BRICK_HEIGHT),
+// the one in column c at x = brick_col_x(c)
+static const uint8_t brick_atlas[3600] = {
+    0x03, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3a, 0xaa, 0xaa, 0xaa, 0xaa,
+    0xaa, 0x83, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3a, 0xaa, 0xaa, 0xaa,
+    0xaa, 0xaa, 0x83, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3a, 0xaa, 0xaa,
+    0xaa, 0xaa, 0xaa, 0x80, 0x03, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3a,
+    0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x83, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xa8,
+    0x3a, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x83, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+    0xa8, 0x3a, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x80, 0x03, 0xaa, 0xaa, 0xaa,
+    0xaa, 0xaa, 0xa8, 0x3a, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x83, 0xaa, 0xaa,
+    0xaa, 0xaa, 0xaa, 0xa8, 0x3a, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x83, 0xaa,
+    0xaa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3a, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x80,
+    0x03, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3a, 0xaa, 0xaa, 0xaa, 0xaa,
+    0xaa, 0x83, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3a, 0xaa, 0xaa, 0xaa,
+    0xaa, 0xaa, 0x83, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3a, 0xaa, 0xaa,
+    0xaa, 0xaa, 0xaa, 0x80, 0x03, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3a,
+    0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x83, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xa8,
+    0x3a, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x83, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+    0xa8, 0x3a, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x80, 0x03, 0xaa, 0xaa, 0xaa,
+    0xaa, 0xaa, 0xa8, 0x3a, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x83, 0xaa, 0xaa,
+    0xaa, 0xaa, 0xaa, 0xa8, 0x3a, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x83, 0xaa,
+    0xaa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3a, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x80,
+    0x03, 0xea, 0xaa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3e, 0xaa, 0xaa, 0xaa, 0xaa,
+    0xaa, 0x83, 0xea, 0xaa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3e, 0xaa, 0xaa, 0xaa,
+    0xaa, 0xaa, 0x83, 0xea, 0xaa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3e, 0xaa, 0xaa,
+    0xaa, 0xaa, 0xaa, 0x80, 0x03, 0xea, 0xaa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3e,
+    0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x83, 0xea, 0xaa, 0xaa, 0xaa, 0xaa, 0xa8,
+    0x3e, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x83, 0xea, 0xaa, 0xaa, 0xaa, 0xaa,
+    0xa8, 0x3e, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x80, 0x03, 0xea, 0xaa, 0xaa,
+    0xaa, 0xaa, 0xa8, 0x3e, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x83, 0xea, 0xaa,
+    0xaa, 0xaa, 0xaa, 0xa8, 0x3e, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x83, 0xea,
+    0xaa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3e, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x80,
+    0x03, 0xea, 0xaa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3e, 0xaa, 0xaa, 0xaa, 0xaa,
+    0xaa, 0x83, 0xea, 0xaa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3e, 0xaa, 0xaa, 0xaa,
+    0xaa, 0xaa, 0x83, 0xea, 0xaa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3e, 0xaa, 0xaa,
+    0xaa, 0xaa, 0xaa, 0x80, 0x03, 0xea, 0xaa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3e,
+    0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x83, 0xea, 0xaa, 0xaa, 0xaa, 0xaa, 0xa8,
+    0x3e, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x83, 0xea, 0xaa, 0xaa, 0xaa, 0xaa,
+    0xa8, 0x3e, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x80, 0x03, 0xea, 0xaa, 0xaa,
+    0xaa, 0xaa, 0xa8, 0x3e, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x83, 0xea, 0xaa,
+    0xaa, 0xaa, 0xaa, 0xa8, 0x3e, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x83, 0xea,
+    0xaa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3e, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x80,
+    0x03, 0xfa, 0xaa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xaa, 0xaa, 0xaa, 0xaa,
+    0xaa, 0x83, 0xfa, 0xaa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xaa, 0xaa, 0xaa,
+    0xaa, 0xaa, 0x83, 0xfa, 0xaa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xaa, 0xaa,
+    0xaa, 0xaa, 0xaa, 0x80, 0x03, 0xfa, 0xaa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f,
+    0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x83, 0xfa, 0xaa, 0xaa, 0xaa, 0xaa, 0xa8,
+    0x3f, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x83, 0xfa, 0xaa, 0xaa, 0xaa, 0xaa,
+    0xa8, 0x3f, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x80, 0x03, 0xfa, 0xaa, 0xaa,
+    0xaa, 0xaa, 0xa8, 0x3f, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x83, 0xfa, 0xaa,
+    0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x83, 0xfa,
+    0xaa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x80,
+    0x03, 0xfa, 0xaa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xaa, 0xaa, 0xaa, 0xaa,
+    0xaa, 0x83, 0xfa, 0xaa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xaa, 0xaa, 0xaa,
+    0xaa, 0xaa, 0x83, 0xfa, 0xaa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xaa, 0xaa,
+    0xaa, 0xaa, 0xaa, 0x80, 0x03, 0xfa, 0xaa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f,
+    0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x83, 0xfa, 0xaa, 0xaa, 0xaa, 0xaa, 0xa8,
+    0x3f, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x83, 0xfa, 0xaa, 0xaa, 0xaa, 0xaa,
+    0xa8, 0x3f, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x80, 0x03, 0xfa, 0xaa, 0xaa,
+    0xaa, 0xaa, 0xa8, 0x3f, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x83, 0xfa, 0xaa,
+    0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x83, 0xfa,
+    0xaa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x80,
+    0x03, 0xfe, 0xaa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xea, 0xaa, 0xaa, 0xaa,
+    0xaa, 0x83, 0xfe, 0xaa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xea, 0xaa, 0xaa,
+    0xaa, 0xaa, 0x83, 0xfe, 0xaa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xea, 0xaa,
+    0xaa, 0xaa, 0xaa, 0x80, 0x03, 0xfe, 0xaa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f,
+    0xea, 0xaa, 0xaa, 0xaa, 0xaa, 0x83, 0xfe, 0xaa, 0xaa, 0xaa, 0xaa, 0xa8,
+    0x3f, 0xea, 0xaa, 0xaa, 0xaa, 0xaa, 0x83, 0xfe, 0xaa, 0xaa, 0xaa, 0xaa,
+    0xa8, 0x3f, 0xea, 0xaa, 0xaa, 0xaa, 0xaa, 0x80, 0x03, 0xfe, 0xaa, 0xaa,
+    0xaa, 0xaa, 0xa8, 0x3f, 0xea, 0xaa, 0xaa, 0xaa, 0xaa, 0x83, 0xfe, 0xaa,
+    0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xea, 0xaa, 0xaa, 0xaa, 0xaa, 0x83, 0xfe,
+    0xaa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xea, 0xaa, 0xaa, 0xaa, 0xaa, 0x80,
+    0x03, 0xfe, 0xaa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xea, 0xaa, 0xaa, 0xaa,
+    0xaa, 0x83, 0xfe, 0xaa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xea, 0xaa, 0xaa,
+    0xaa, 0xaa, 0x83, 0xfe, 0xaa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xea, 0xaa,
+    0xaa, 0xaa, 0xaa, 0x80, 0x03, 0xfe, 0xaa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f,
+    0xea, 0xaa, 0xaa, 0xaa, 0xaa, 0x83, 0xfe, 0xaa, 0xaa, 0xaa, 0xaa, 0xa8,
+    0x3f, 0xea, 0xaa, 0xaa, 0xaa, 0xaa, 0x83, 0xfe, 0xaa, 0xaa, 0xaa, 0xaa,
+    0xa8, 0x3f, 0xea, 0xaa, 0xaa, 0xaa, 0xaa, 0x80, 0x03, 0xfe, 0xaa, 0xaa,
+    0xaa, 0xaa, 0xa8, 0x3f, 0xea, 0xaa, 0xaa, 0xaa, 0xaa, 0x83, 0xfe, 0xaa,
+    0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xea, 0xaa, 0xaa, 0xaa, 0xaa, 0x83, 0xfe,
+    0xaa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xea, 0xaa, 0xaa, 0xaa, 0xaa, 0x80,
+    0x03, 0xff, 0xaa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xfa, 0xaa, 0xaa, 0xaa,
+    0xaa, 0x83, 0xff, 0xaa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xfa, 0xaa, 0xaa,
+    0xaa, 0xaa, 0x83, 0xff, 0xaa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xfa, 0xaa,
+    0xaa, 0xaa, 0xaa, 0x80, 0x03, 0xff, 0xaa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f,
+    0xfa, 0xaa, 0xaa, 0xaa, 0xaa, 0x83, 0xff, 0xaa, 0xaa, 0xaa, 0xaa, 0xa8,
+    0x3f, 0xfa, 0xaa, 0xaa, 0xaa, 0xaa, 0x83, 0xff, 0xaa, 0xaa, 0xaa, 0xaa,
+    0xa8, 0x3f, 0xfa, 0xaa, 0xaa, 0xaa, 0xaa, 0x80, 0x03, 0xff, 0xaa, 0xaa,
+    0xaa, 0xaa, 0xa8, 0x3f, 0xfa, 0xaa, 0xaa, 0xaa, 0xaa, 0x83, 0xff, 0xaa,
+    0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xfa, 0xaa, 0xaa, 0xaa, 0xaa, 0x83, 0xff,
+    0xaa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xfa, 0xaa, 0xaa, 0xaa, 0xaa, 0x80,
+    0x03, 0xff, 0xaa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xfa, 0xaa, 0xaa, 0xaa,
+    0xaa, 0x83, 0xff, 0xaa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xfa, 0xaa, 0xaa,
+    0xaa, 0xaa, 0x83, 0xff, 0xaa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xfa, 0xaa,
+    0xaa, 0xaa, 0xaa, 0x80, 0x03, 0xff, 0xaa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f,
+    0xfa, 0xaa, 0xaa, 0xaa, 0xaa, 0x83, 0xff, 0xaa, 0xaa, 0xaa, 0xaa, 0xa8,
+    0x3f, 0xfa, 0xaa, 0xaa, 0xaa, 0xaa, 0x83, 0xff, 0xaa, 0xaa, 0xaa, 0xaa,
+    0xa8, 0x3f, 0xfa, 0xaa, 0xaa, 0xaa, 0xaa, 0x80, 0x03, 0xff, 0xaa, 0xaa,
+    0xaa, 0xaa, 0xa8, 0x3f, 0xfa, 0xaa, 0xaa, 0xaa, 0xaa, 0x83, 0xff, 0xaa,
+    0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xfa, 0xaa, 0xaa, 0xaa, 0xaa, 0x83, 0xff,
+    0xaa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xfa, 0xaa, 0xaa, 0xaa, 0xaa, 0x80,
+    0x03, 0xff, 0xea, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xfe, 0xaa, 0xaa, 0xaa,
+    0xaa, 0x83, 0xff, 0xea, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xfe, 0xaa, 0xaa,
+    0xaa, 0xaa, 0x83, 0xff, 0xea, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xfe, 0xaa,
+    0xaa, 0xaa, 0xaa, 0x80, 0x03, 0xff, 0xea, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f,
+    0xfe, 0xaa, 0xaa, 0xaa, 0xaa, 0x83, 0xff, 0xea, 0xaa, 0xaa, 0xaa, 0xa8,
+    0x3f, 0xfe, 0xaa, 0xaa, 0xaa, 0xaa, 0x83, 0xff, 0xea, 0xaa, 0xaa, 0xaa,
+    0xa8, 0x3f, 0xfe, 0xaa, 0xaa, 0xaa, 0xaa, 0x80, 0x03, 0xff, 0xea, 0xaa,
+    0xaa, 0xaa, 0xa8, 0x3f, 0xfe, 0xaa, 0xaa, 0xaa, 0xaa, 0x83, 0xff, 0xea,
+    0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xfe, 0xaa, 0xaa, 0xaa, 0xaa, 0x83, 0xff,
+    0xea, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xfe, 0xaa, 0xaa, 0xaa, 0xaa, 0x80,
+    0x03, 0xff, 0xea, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xfe, 0xaa, 0xaa, 0xaa,
+    0xaa, 0x83, 0xff, 0xea, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xfe, 0xaa, 0xaa,
+    0xaa, 0xaa, 0x83, 0xff, 0xea, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xfe, 0xaa,
+    0xaa, 0xaa, 0xaa, 0x80, 0x03, 0xff, 0xea, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f,
+    0xfe, 0xaa, 0xaa, 0xaa, 0xaa, 0x83, 0xff, 0xea, 0xaa, 0xaa, 0xaa, 0xa8,
+    0x3f, 0xfe, 0xaa, 0xaa, 0xaa, 0xaa, 0x83, 0xff, 0xea, 0xaa, 0xaa, 0xaa,
+    0xa8, 0x3f, 0xfe, 0xaa, 0xaa, 0xaa, 0xaa, 0x80, 0x03, 0xff, 0xea, 0xaa,
+    0xaa, 0xaa, 0xa8, 0x3f, 0xfe, 0xaa, 0xaa, 0xaa, 0xaa, 0x83, 0xff, 0xea,
+    0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xfe, 0xaa, 0xaa, 0xaa, 0xaa, 0x83, 0xff,
+    0xea, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xfe, 0xaa, 0xaa, 0xaa, 0xaa, 0x80,
+    0x03, 0xff, 0xfa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xaa, 0xaa, 0xaa,
+    0xaa, 0x83, 0xff, 0xfa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xaa, 0xaa,
+    0xaa, 0xaa, 0x83, 0xff, 0xfa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xaa,
+    0xaa, 0xaa, 0xaa, 0x80, 0x03, 0xff, 0xfa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f,
+    0xff, 0xaa, 0xaa, 0xaa, 0xaa, 0x83, 0xff, 0xfa, 0xaa, 0xaa, 0xaa, 0xa8,
+    0x3f, 0xff, 0xaa, 0xaa, 0xaa, 0xaa, 0x83, 0xff, 0xfa, 0xaa, 0xaa, 0xaa,
+    0xa8, 0x3f, 0xff, 0xaa, 0xaa, 0xaa, 0xaa, 0x80, 0x03, 0xff, 0xfa, 0xaa,
+    0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xaa, 0xaa, 0xaa, 0xaa, 0x83, 0xff, 0xfa,
+    0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xaa, 0xaa, 0xaa, 0xaa, 0x83, 0xff,
+    0xfa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xaa, 0xaa, 0xaa, 0xaa, 0x80,
+    0x03, 0xff, 0xfa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xaa, 0xaa, 0xaa,
+    0xaa, 0x83, 0xff, 0xfa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xaa, 0xaa,
+    0xaa, 0xaa, 0x83, 0xff, 0xfa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xaa,
+    0xaa, 0xaa, 0xaa, 0x80, 0x03, 0xff, 0xfa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f,
+    0xff, 0xaa, 0xaa, 0xaa, 0xaa, 0x83, 0xff, 0xfa, 0xaa, 0xaa, 0xaa, 0xa8,
+    0x3f, 0xff, 0xaa, 0xaa, 0xaa, 0xaa, 0x83, 0xff, 0xfa, 0xaa, 0xaa, 0xaa,
+    0xa8, 0x3f, 0xff, 0xaa, 0xaa, 0xaa, 0xaa, 0x80, 0x03, 0xff, 0xfa, 0xaa,
+    0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xaa, 0xaa, 0xaa, 0xaa, 0x83, 0xff, 0xfa,
+    0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xaa, 0xaa, 0xaa, 0xaa, 0x83, 0xff,
+    0xfa, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xaa, 0xaa, 0xaa, 0xaa, 0x80,
+    0x03, 0xff, 0xfe, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xea, 0xaa, 0xaa,
+    0xaa, 0x83, 0xff, 0xfe, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xea, 0xaa,
+    0xaa, 0xaa, 0x83, 0xff, 0xfe, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xea,
+    0xaa, 0xaa, 0xaa, 0x80, 0x03, 0xff, 0xfe, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f,
+    0xff, 0xea, 0xaa, 0xaa, 0xaa, 0x83, 0xff, 0xfe, 0xaa, 0xaa, 0xaa, 0xa8,
+    0x3f, 0xff, 0xea, 0xaa, 0xaa, 0xaa, 0x83, 0xff, 0xfe, 0xaa, 0xaa, 0xaa,
+    0xa8, 0x3f, 0xff, 0xea, 0xaa, 0xaa, 0xaa, 0x80, 0x03, 0xff, 0xfe, 0xaa,
+    0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xea, 0xaa, 0xaa, 0xaa, 0x83, 0xff, 0xfe,
+    0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xea, 0xaa, 0xaa, 0xaa, 0x83, 0xff,
+    0xfe, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xea, 0xaa, 0xaa, 0xaa, 0x80,
+    0x03, 0xff, 0xfe, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xea, 0xaa, 0xaa,
+    0xaa, 0x83, 0xff, 0xfe, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xea, 0xaa,
+    0xaa, 0xaa, 0x83, 0xff, 0xfe, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xea,
+    0xaa, 0xaa, 0xaa, 0x80, 0x03, 0xff, 0xfe, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f,
+    0xff, 0xea, 0xaa, 0xaa, 0xaa, 0x83, 0xff, 0xfe, 0xaa, 0xaa, 0xaa, 0xa8,
+    0x3f, 0xff, 0xea, 0xaa, 0xaa, 0xaa, 0x83, 0xff, 0xfe, 0xaa, 0xaa, 0xaa,
+    0xa8, 0x3f, 0xff, 0xea, 0xaa, 0xaa, 0xaa, 0x80, 0x03, 0xff, 0xfe, 0xaa,
+    0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xea, 0xaa, 0xaa, 0xaa, 0x83, 0xff, 0xfe,
+    0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xea, 0xaa, 0xaa, 0xaa, 0x83, 0xff,
+    0xfe, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xea, 0xaa, 0xaa, 0xaa, 0x80,
+    0x03, 0xff, 0xff, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xfa, 0xaa, 0xaa,
+    0xaa, 0x83, 0xff, 0xff, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xfa, 0xaa,
+    0xaa, 0xaa, 0x83, 0xff, 0xff, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xfa,
+    0xaa, 0xaa, 0xaa, 0x80, 0x03, 0xff, 0xff, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f,
+    0xff, 0xfa, 0xaa, 0xaa, 0xaa, 0x83, 0xff, 0xff, 0xaa, 0xaa, 0xaa, 0xa8,
+    0x3f, 0xff, 0xfa, 0xaa, 0xaa, 0xaa, 0x83, 0xff, 0xff, 0xaa, 0xaa, 0xaa,
+    0xa8, 0x3f, 0xff, 0xfa, 0xaa, 0xaa, 0xaa, 0x80, 0x03, 0xff, 0xff, 0xaa,
+    0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xfa, 0xaa, 0xaa, 0xaa, 0x83, 0xff, 0xff,
+    0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xfa, 0xaa, 0xaa, 0xaa, 0x83, 0xff,
+    0xff, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xfa, 0xaa, 0xaa, 0xaa, 0x80,
+    0x03, 0xff, 0xff, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xfa, 0xaa, 0xaa,
+    0xaa, 0x83, 0xff, 0xff, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xfa, 0xaa,
+    0xaa, 0xaa, 0x83, 0xff, 0xff, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xfa,
+    0xaa, 0xaa, 0xaa, 0x80, 0x03, 0xff, 0xff, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f,
+    0xff, 0xfa, 0xaa, 0xaa, 0xaa, 0x83, 0xff, 0xff, 0xaa, 0xaa, 0xaa, 0xa8,
+    0x3f, 0xff, 0xfa, 0xaa, 0xaa, 0xaa, 0x83, 0xff, 0xff, 0xaa, 0xaa, 0xaa,
+    0xa8, 0x3f, 0xff, 0xfa, 0xaa, 0xaa, 0xaa, 0x80, 0x03, 0xff, 0xff, 0xaa,
+    0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xfa, 0xaa, 0xaa, 0xaa, 0x83, 0xff, 0xff,
+    0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xfa, 0xaa, 0xaa, 0xaa, 0x83, 0xff,
+    0xff, 0xaa, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xfa, 0xaa, 0xaa, 0xaa, 0x80,
+    0x03, 0xff, 0xff, 0xea, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xfe, 0xaa, 0xaa,
+    0xaa, 0x83, 0xff, 0xff, 0xea, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xfe, 0xaa,
+    0xaa, 0xaa, 0x83, 0xff, 0xff, 0xea, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xfe,
+    0xaa, 0xaa, 0xaa, 0x80, 0x03, 0xff, 0xff, 0xea, 0xaa, 0xaa, 0xa8, 0x3f,
+    0xff, 0xfe, 0xaa, 0xaa, 0xaa, 0x83, 0xff, 0xff, 0xea, 0xaa, 0xaa, 0xa8,
+    0x3f, 0xff, 0xfe, 0xaa, 0xaa, 0xaa, 0x83, 0xff, 0xff, 0xea, 0xaa, 0xaa,
+    0xa8, 0x3f, 0xff, 0xfe, 0xaa, 0xaa, 0xaa, 0x80, 0x03, 0xff, 0xff, 0xea,
+    0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xfe, 0xaa, 0xaa, 0xaa, 0x83, 0xff, 0xff,
+    0xea, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xfe, 0xaa, 0xaa, 0xaa, 0x83, 0xff,
+    0xff, 0xea, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xfe, 0xaa, 0xaa, 0xaa, 0x80,
+    0x03, 0xff, 0xff, 0xea, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xfe, 0xaa, 0xaa,
+    0xaa, 0x83, 0xff, 0xff, 0xea, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xfe, 0xaa,
+    0xaa, 0xaa, 0x83, 0xff, 0xff, 0xea, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xfe,
+    0xaa, 0xaa, 0xaa, 0x80, 0x03, 0xff, 0xff, 0xea, 0xaa, 0xaa, 0xa8, 0x3f,
+    0xff, 0xfe, 0xaa, 0xaa, 0xaa, 0x83, 0xff, 0xff, 0xea, 0xaa, 0xaa, 0xa8,
+    0x3f, 0xff, 0xfe, 0xaa, 0xaa, 0xaa, 0x83, 0xff, 0xff, 0xea, 0xaa, 0xaa,
+    0xa8, 0x3f, 0xff, 0xfe, 0xaa, 0xaa, 0xaa, 0x80, 0x03, 0xff, 0xff, 0xea,
+    0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xfe, 0xaa, 0xaa, 0xaa, 0x83, 0xff, 0xff,
+    0xea, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xfe, 0xaa, 0xaa, 0xaa, 0x83, 0xff,
+    0xff, 0xea, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xfe, 0xaa, 0xaa, 0xaa, 0x80,
+    0x03, 0xff, 0xff, 0xfa, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xff, 0xaa, 0xaa,
+    0xaa, 0x83, 0xff, 0xff, 0xfa, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xff, 0xaa,
+    0xaa, 0xaa, 0x83, 0xff, 0xff, 0xfa, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xff,
+    0xaa, 0xaa, 0xaa, 0x80, 0x03, 0xff, 0xff, 0xfa, 0xaa, 0xaa, 0xa8, 0x3f,
+    0xff, 0xff, 0xaa, 0xaa, 0xaa, 0x83, 0xff, 0xff, 0xfa, 0xaa, 0xaa, 0xa8,
+    0x3f, 0xff, 0xff, 0xaa, 0xaa, 0xaa, 0x83, 0xff, 0xff, 0xfa, 0xaa, 0xaa,
+    0xa8, 0x3f, 0xff, 0xff, 0xaa, 0xaa, 0xaa, 0x80, 0x03, 0xff, 0xff, 0xfa,
+    0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xff, 0xaa, 0xaa, 0xaa, 0x83, 0xff, 0xff,
+    0xfa, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xff, 0xaa, 0xaa, 0xaa, 0x83, 0xff,
+    0xff, 0xfa, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xff, 0xaa, 0xaa, 0xaa, 0x80,
+    0x03, 0xff, 0xff, 0xfa, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xff, 0xaa, 0xaa,
+    0xaa, 0x83, 0xff, 0xff, 0xfa, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xff, 0xaa,
+    0xaa, 0xaa, 0x83, 0xff, 0xff, 0xfa, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xff,
+    0xaa, 0xaa, 0xaa, 0x80, 0x03, 0xff, 0xff, 0xfa, 0xaa, 0xaa, 0xa8, 0x3f,
+    0xff, 0xff, 0xaa, 0xaa, 0xaa, 0x83, 0xff, 0xff, 0xfa, 0xaa, 0xaa, 0xa8,
+    0x3f, 0xff, 0xff, 0xaa, 0xaa, 0xaa, 0x83, 0xff, 0xff, 0xfa, 0xaa, 0xaa,
+    0xa8, 0x3f, 0xff, 0xff, 0xaa, 0xaa, 0xaa, 0x80, 0x03, 0xff, 0xff, 0xfa,
+    0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xff, 0xaa, 0xaa, 0xaa, 0x83, 0xff, 0xff,
+    0xfa, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xff, 0xaa, 0xaa, 0xaa, 0x83, 0xff,
+    0xff, 0xfa, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xff, 0xaa, 0xaa, 0xaa, 0x80,
+    0x03, 0xff, 0xff, 0xfe, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xff, 0xea, 0xaa,
+    0xaa, 0x83, 0xff, 0xff, 0xfe, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xff, 0xea,
+    0xaa, 0xaa, 0x83, 0xff, 0xff, 0xfe, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xff,
+    0xea, 0xaa, 0xaa, 0x80, 0x03, 0xff, 0xff, 0xfe, 0xaa, 0xaa, 0xa8, 0x3f,
+    0xff, 0xff, 0xea, 0xaa, 0xaa, 0x83, 0xff, 0xff, 0xfe, 0xaa, 0xaa, 0xa8,
+    0x3f, 0xff, 0xff, 0xea, 0xaa, 0xaa, 0x83, 0xff, 0xff, 0xfe, 0xaa, 0xaa,
+    0xa8, 0x3f, 0xff, 0xff, 0xea, 0xaa, 0xaa, 0x80, 0x03, 0xff, 0xff, 0xfe,
+    0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xff, 0xea, 0xaa, 0xaa, 0x83, 0xff, 0xff,
+    0xfe, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xff, 0xea, 0xaa, 0xaa, 0x83, 0xff,
+    0xff, 0xfe, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xff, 0xea, 0xaa, 0xaa, 0x80,
+    0x03, 0xff, 0xff, 0xfe, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xff, 0xea, 0xaa,
+    0xaa, 0x83, 0xff, 0xff, 0xfe, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xff, 0xea,
+    0xaa, 0xaa, 0x83, 0xff, 0xff, 0xfe, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xff,
+    0xea, 0xaa, 0xaa, 0x80, 0x03, 0xff, 0xff, 0xfe, 0xaa, 0xaa, 0xa8, 0x3f,
+    0xff, 0xff, 0xea, 0xaa, 0xaa, 0x83, 0xff, 0xff, 0xfe, 0xaa, 0xaa, 0xa8,
+    0x3f, 0xff, 0xff, 0xea, 0xaa, 0xaa, 0x83, 0xff, 0xff, 0xfe, 0xaa, 0xaa,
+    0xa8, 0x3f, 0xff, 0xff, 0xea, 0xaa, 0xaa, 0x80, 0x03, 0xff, 0xff, 0xfe,
+    0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xff, 0xea, 0xaa, 0xaa, 0x83, 0xff, 0xff,
+    0xfe, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xff, 0xea, 0xaa, 0xaa, 0x83, 0xff,
+    0xff, 0xfe, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xff, 0xea, 0xaa, 0xaa, 0x80,
+    0x03, 0xff, 0xff, 0xff, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xff, 0xfa, 0xaa,
+    0xaa, 0x83, 0xff, 0xff, 0xff, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xff, 0xfa,
+    0xaa, 0xaa, 0x83, 0xff, 0xff, 0xff, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xff,
+    0xfa, 0xaa, 0xaa, 0x80, 0x03, 0xff, 0xff, 0xff, 0xaa, 0xaa, 0xa8, 0x3f,
+    0xff, 0xff, 0xfa, 0xaa, 0xaa, 0x83, 0xff, 0xff, 0xff, 0xaa, 0xaa, 0xa8,
+    0x3f, 0xff, 0xff, 0xfa, 0xaa, 0xaa, 0x83, 0xff, 0xff, 0xff, 0xaa, 0xaa,
+    0xa8, 0x3f, 0xff, 0xff, 0xfa, 0xaa, 0xaa, 0x80, 0x03, 0xff, 0xff, 0xff,
+    0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xff, 0xfa, 0xaa, 0xaa, 0x83, 0xff, 0xff,
+    0xff, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xff, 0xfa, 0xaa, 0xaa, 0x83, 0xff,
+    0xff, 0xff, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xff, 0xfa, 0xaa, 0xaa, 0x80,
+    0x03, 0xff, 0xff, 0xff, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xff, 0xfa, 0xaa,
+    0xaa, 0x83, 0xff, 0xff, 0xff, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xff, 0xfa,
+    0xaa, 0xaa, 0x83, 0xff, 0xff, 0xff, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xff,
+    0xfa, 0xaa, 0xaa, 0x80, 0x03, 0xff, 0xff, 0xff, 0xaa, 0xaa, 0xa8, 0x3f,
+    0xff, 0xff, 0xfa, 0xaa, 0xaa, 0x83, 0xff, 0xff, 0xff, 0xaa, 0xaa, 0xa8,
+    0x3f, 0xff, 0xff, 0xfa, 0xaa, 0xaa, 0x83, 0xff, 0xff, 0xff, 0xaa, 0xaa,
+    0xa8, 0x3f, 0xff, 0xff, 0xfa, 0xaa, 0xaa, 0x80, 0x03, 0xff, 0xff, 0xff,
+    0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xff, 0xfa, 0xaa, 0xaa, 0x83, 0xff, 0xff,
+    0xff, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xff, 0xfa, 0xaa, 0xaa, 0x83, 0xff,
+    0xff, 0xff, 0xaa, 0xaa, 0xa8, 0x3f, 0xff, 0xff, 0xfa, 0xaa, 0xaa, 0x80,
+    0x03, 0xff, 0xff, 0xff, 0xea, 0xaa, 0xa8, 0x3f, 0xff, 0xff, 0xfe, 0xaa,
+    0xaa, 0x83, 0xff, 0xff, 0xff, 0xea, 0xaa, 0xa8, 0x3f, 0xff, 0xff, 0xfe,
+    0xaa, 0xaa, 0x83, 0xff, 0xff, 0xff, 0xea, 0xaa, 0xa8, 0x3f, 0xff, 0xff,
+    0xfe, 0xaa, 0xaa, 0x80, 0x03, 0xff, 0xff, 0xff, 0xea, 0xaa, 0xa8, 0x3f,
+    0xff, 0xff, 0xfe, 0xaa, 0xaa, 0x83, 0xff, 0xff, 0xff, 0xea, 0xaa, 0xa8,
+    0x3f, 0xff, 0xff, 0xfe, 0xaa, 0xaa, 0x83, 0xff, 0xff, 0xff, 0xea, 0xaa,
+    0xa8, 0x3f, 0xff, 0xff, 0xfe, 0xaa, 0xaa, 0x80, 0x03, 0xff, 0xff, 0xff,
+    0xea, 0xaa, 0xa8, 0x3f, 0xff, 0xff, 0xfe, 0xaa, 0xaa, 0x83, 0xff, 0xff,
+    0xff, 0xea, 0xaa, 0xa8, 0x3f, 0xff, 0xff, 0xfe, 0xaa, 0xaa, 0x83, 0xff,
+    0xff, 0xff, 0xea, 0xaa, 0xa8, 0x3f, 0xff, 0xff, 0xfe, 0xaa, 0xaa, 0x80,
+    0x03, 0xff, 0xff, 0xff, 0xea, 0xaa, 0xa8, 0x3f, 0xff, 0xff, 0xfe, 0xaa,
+    0xaa, 0x83, 0xff, 0xff, 0xff, 0xea, 0xaa, 0xa8, 0x3f, 0xff, 0xff, 0xfe,
+    0xaa, 0xaa, 0x83, 0xff, 0xff, 0xff, 0xea, 0xaa, 0xa8, 0x3f, 0xff, 0xff,
+    0xfe, 0xaa, 0xaa, 0x80, 0x03, 0xff, 0xff, 0xff, 0xea, 0xaa, 0xa8, 0x3f,
+    0xff, 0xff, 0xfe, 0xaa, 0xaa, 0x83, 0xff, 0xff, 0xff, 0xea, 0xaa, 0xa8,
+    0x3f, 0xff, 0xff, 0xfe, 0xaa, 0xaa, 0x83, 0xff, 0xff, 0xff, 0xea, 0xaa,
+    0xa8, 0x3f, 0xff, 0xff, 0xfe, 0xaa, 0xaa, 0x80, 0x03, 0xff, 0xff, 0xff,
+    0xea, 0xaa, 0xa8, 0x3f, 0xff, 0xff, 0xfe, 0xaa, 0xaa, 0x83, 0xff, 0xff,
+    0xff, 0xea, 0xaa, 0xa8, 0x3f, 0xff, 0xff, 0xfe, 0xaa, 0xaa, 0x83, 0xff,
+    0xff, 0xff, 0xea, 0xaa, 0xa8, 0x3f, 0xff, 0xff, 0xfe, 0xaa, 0xaa, 0x80,
+    0x03, 0xff, 0xff, 0xff, 0xfa, 0xaa, 0xa8, 0x3f, 0xff, 0xff, 0xff, 0xaa,
+    0xaa, 0x83, 0xff, 0xff, 0xff, 0xfa, 0xaa, 0xa8, 0x3f, 0xff, 0xff, 0xff,
+    0xaa, 0xaa, 0x83, 0xff, 0xff, 0xff, 0xfa, 0xaa, 0xa8, 0x3f, 0xff, 0xff,
+    0xff, 0xaa, 0xaa, 0x80, 0x03, 0xff, 0xff, 0xff, 0xfa, 0xaa, 0xa8, 0x3f,
+    0xff, 0xff, 0xff, 0xaa, 0xaa, 0x83, 0xff, 0xff, 0xff, 0xfa, 0xaa, 0xa8,
+    0x3f, 0xff, 0xff, 0xff, 0xaa, 0xaa, 0x83, 0xff, 0xff, 0xff, 0xfa, 0xaa,
+    0xa8, 0x3f, 0xff, 0xff, 0xff, 0xaa, 0xaa, 0x80, 0x03, 0xff, 0xff, 0xff,
+    0xfa, 0xaa, 0xa8, 0x3f, 0xff, 0xff, 0xff, 0xaa, 0xaa, 0x83, 0xff, 0xff,
+    0xff, 0xfa, 0xaa, 0xa8, 0x3f, 0xff, 0xff, 0xff, 0xaa, 0xaa, 0x83, 0xff,
+    0xff, 0xff, 0xfa, 0xaa, 0xa8, 0x3f, 0xff, 0xff, 0xff, 0xaa, 0xaa, 0x80,
+    0x03, 0xff, 0xff, 0xff, 0xfa, 0xaa, 0xa8, 0x3f, 0xff, 0xff, 0xff, 0xaa,
+    0xaa, 0x83, 0xff, 0xff, 0xff, 0xfa, 0xaa, 0xa8, 0x3f, 0xff, 0xff, 0xff,
+    0xaa, 0xaa, 0x83, 0xff, 0xff, 0xff, 0xfa, 0xaa, 0xa8, 0x3f, 0xff, 0xff,
+    0xff, 0xaa, 0xaa, 0x80, 0x03, 0xff, 0xff, 0xff, 0xfa, 0xaa, 0xa8, 0x3f,
+    0xff, 0xff, 0xff, 0xaa, 0xaa, 0x83, 0xff, 0xff, 0xff, 0xfa, 0xaa, 0xa8,
+    0x3f, 0xff, 0xff, 0xff, 0xaa, 0xaa, 0x83, 0xff, 0xff, 0xff, 0xfa, 0xaa,
+    0xa8, 0x3f, 0xff, 0xff, 0xff, 0xaa, 0xaa, 0x80, 0x03, 0xff, 0xff, 0xff,
+    0xfa, 0xaa, 0xa8, 0x3f, 0xff, 0xff, 0xff, 0xaa, 0xaa, 0x83, 0xff, 0xff,
+    0xff, 0xfa, 0xaa, 0xa8, 0x3f, 0xff, 0xff, 0xff, 0xaa, 0xaa, 0x83, 0xff,
+    0xff, 0xff, 0xfa, 0xaa, 0xa8, 0x3f, 0xff, 0xff, 0xff, 0xaa, 0xaa, 0x80,
+};
+
+// Ball i is at x = LIVES_X + i * (BALL_DIAMETER + 1)
+static const uint8_t ball_strip[44] = {
+    0x3f, 0xcf, 0xf3, 0xfc, 0xff, 0x3f, 0xcf, 0xf3, 0xfc, 0xff, 0x00, 0x3a,
+    0xce, 0xb3, 0xac, 0xeb, 0x3a, 0xce, 0xb3, 0xac, 0xeb, 0x00, 0x3a, 0xce,
+    0xb3, 0xac, 0xeb, 0x3a, 0xce, 0xb3, 0xac, 0xeb, 0x00, 0x3f, 0xcf, 0xf3,
+    0xfc, 0xff, 0x3f, 0xcf, 0xf3, 0xfc, 0xff, 0x00,
+};
+
+#endif
@@ -0,0 +1,354 @@
+// Batch simulation: runs thousands of independent games at once on all
+// cores through game_step() alone (no drawing, no runtime calls), then
+// reports frames per second and how the games went.
+//
+// A session is either a replay from the command line, checked against
+// the state it recorded, or a game seeded with its index: the seed picks
+// the level, game mode, palette and endless seed, and the autoplayer
+// plays with random presses of the other buttons mixed in.
+//
+// Sessions go through a work-stealing pool. Every worker starts with an
+// even share of them and takes them from the front of its own queue,
+// once that's empty it steals the back half of the fullest other queue.
+// Sessions differ a lot in cost (multi-ball games, games lost early),
+// so this keeps all cores busy to the end.
+//
+// The results don't depend on the number of threads: the checksum
+// printed at the end is of every session's end state, in order.
+#include "main.c"
+
+#include "replay_file.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define DEFAULT_SESSIONS      4096
+#define DEFAULT_SESSION_FRAMES 3600
+#define MAX_THREADS           256
+#define MAX_REPLAYS           256
+
+typedef struct {
+    unsigned long frames;
+    unsigned long clears;
+    unsigned long losses;
+    uint32_t checksum;
+    Screen_Kind screen_kind;
+    Level level;
+    Replay_Result replay_result;
+} Session_Result;
+
+// Sessions [begin, end) left to a worker
+typedef struct {
+    pthread_mutex_t lock;
+    uint32_t begin;
+    uint32_t end;
+} Work_Queue;
+
+typedef struct {
+    uint32_t num_sessions;
+    unsigned long session_frames;
+    uint32_t seed;
+    const Replay_Header *replays[MAX_REPLAYS];
+    uint32_t num_replays;
+
+    Session_Result *results;
+    Work_Queue queues[MAX_THREADS];
+    int num_threads;
+} Batch;
+
+typedef struct {
+    Batch *batch;
+    int index;
+    unsigned long steals;
+} Worker;
+
+// Random presses on top of the autoplayer, now and then for a while
+typedef struct {
+    uint32_t random;
+    uint8_t held;
+    uint8_t frames_left;
+} Seeded_Input;
+
+static const uint8_t seeded_buttons[] = {
+    BUTTON_1, BUTTON_2, BUTTON_LEFT, BUTTON_RIGHT, BUTTON_UP, BUTTON_DOWN,
+};
+
+static uint8_t seeded_input(Seeded_Input *input, const Game_State *state) {
+    if (input->frames_left == 0 && random_below(&input->random, 64) == 0) {
+        input->held = seeded_buttons[random_below(&input->random, ARRAY_LEN(seeded_buttons))];
+        input->frames_left = (uint8_t) (1 + random_below(&input->random, 30));
+    }
+    if (input->frames_left > 0) {
+        input->frames_left--;
+        return input->held;
+    }
+    return autoplayer_input(state);
+}
+
+static void count_frame(Session_Result *result, const Game_State *state,
+                        Screen_Kind screen_kind) {
+    result->frames++;
+    if (screen_kind == GAME_SCREEN && state->screen_kind == GAME_OVER_SCREEN) {
+        if (any_brick_alive(state)) {
+            result->losses++;
+        } else {
+            result->clears++;
+        }
+    }
+}
+
+static void run_seeded_session(const Batch *batch, uint32_t index, Game_State *state,
+                               Session_Result *result) {
+    uint8_t key[] = {
+        (uint8_t) index, (uint8_t) (index >> 8), (uint8_t) (index >> 16), (uint8_t) (index >> 24),
+        (uint8_t) batch->seed, (uint8_t) (batch->seed >> 8),
+        (uint8_t) (batch->seed >> 16), (uint8_t) (batch->seed >> 24),
+    };
+    // xorshift32 never leaves 0
+    Seeded_Input input = {.random=hash_bytes(HASH_SEED, key, sizeof(key)) | 1};
+    Level level = (Level) random_below(&input.random, NUM_LEVELS);
+    Game_Mode game_mode = (Game_Mode) random_below(&input.random, NUM_GAME_MODES);
+    Palette_Picker palette = (Palette_Picker) random_below(&input.random, NUM_PALETTE_PICKER);
+    uint32_t endless_seed = random_next(&input.random);
+    game_reset(state, level, palette, game_mode, endless_seed, ARENA_BRICKS);
+    state->endless = random_below(&input.random, 2);
+
+    for (unsigned long frame = 0; frame < batch->session_frames; frame++) {
+        Screen_Kind screen_kind = state->screen_kind;
+        game_step(state, seeded_input(&input, state), 0, NULL);
+        count_frame(result, state, screen_kind);
+    }
+}
+
+// Same start as start_replay()
+static void run_replay_session(const Replay_Header *header, Game_State *state,
+                               Session_Result *result) {
+    game_reset(state, (Level) (header->level % NUM_LEVELS),
+               (Palette_Picker) (header->palette % NUM_PALETTE_PICKER),
+               (Game_Mode) (header->game_mode % NUM_GAME_MODES), header->endless_seed,
+               clamp_int(header->arena_num_bricks, 1, ARENA_MAX_BRICKS));
+    Replay_Player player;
+    replay_play(&player, header, (const Replay_Run *) (header + 1));
+    uint8_t gamepad;
+    while (replay_next(&player, &gamepad)) {
+        Screen_Kind screen_kind = state->screen_kind;
+        game_step(state, gamepad, 0, NULL);
+        count_frame(result, state, screen_kind);
+    }
+    result->replay_result = game_state_checksum(state) == header->checksum
+                          ? REPLAY_MATCHED : REPLAY_DIVERGED;
+}
+
+// Replays come first, then the seeded sessions
+static void run_session(const Batch *batch, uint32_t index, Game_State *state) {
+    Session_Result *result = &batch->results[index];
+    memset(state, 0, sizeof(*state));
+    memset(result, 0, sizeof(*result));
+    if (index < batch->num_replays) {
+        run_replay_session(batch->replays[index], state, result);
+    } else {
+        run_seeded_session(batch, index - batch->num_replays, state, result);
+    }
+    result->checksum = game_state_checksum(state);
+    result->screen_kind = state->screen_kind;
+    result->level = state->level;
+}
+
+static bool take_session(Work_Queue *queue, uint32_t *index) {
+    pthread_mutex_lock(&queue->lock);
+    bool taken = queue->begin < queue->end;
+    if (taken) {
+        *index = queue->begin++;
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return taken;
+}
+
+// Moves the back half of the fullest other queue to the worker's own,
+// returns false once there's nothing left anywhere
+static bool steal_sessions(Worker *worker) {
+    Batch *batch = worker->batch;
+    for (;;) {
+        int victim = -1;
+        uint32_t most = 0;
+        for (int i = 0; i < batch->num_threads; i++) {
+            // A racy peek, the steal itself is done under the lock
+            Work_Queue *queue = &batch->queues[i];
+            pthread_mutex_lock(&queue->lock);
+            uint32_t left = queue->end - queue->begin;
+            pthread_mutex_unlock(&queue->lock);
+            if (i != worker->index && left > most) {
+                most = left;
+                victim = i;
+            }
+        }
+        if (victim < 0) {
+            return false;
+        }
+
+        Work_Queue *from = &batch->queues[victim];
+        pthread_mutex_lock(&from->lock);
+        uint32_t left = from->end - from->begin;
+        uint32_t begin = from->end - (left + 1) / 2;
+        uint32_t end = from->end;
+        from->end = begin;
+        pthread_mutex_unlock(&from->lock);
+        if (begin == end) {
+            // Emptied in the meantime, look again
+            continue;
+        }
+
+        Work_Queue *own = &batch->queues[worker->index];
+        pthread_mutex_lock(&own->lock);
+        own->begin = begin;
+        own->end = end;
+        pthread_mutex_unlock(&own->lock);
+        worker->steals++;
+        return true;
+    }
+}
+
+static void *run_worker(void *arg) {
+    Worker *worker = arg;
+    Game_State *state = malloc(sizeof(*state));
+    if (!state) {
+        fprintf(stderr, "ERROR: Out of memory\n");
+        exit(1);
+    }
+    Work_Queue *own = &worker->batch->queues[worker->index];
+    do {
+        uint32_t index;
+        while (take_session(own, &index)) {
+            run_session(worker->batch, index, state);
+        }
+    } while (steal_sessions(worker));
+    free(state);
+    return NULL;
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+}
+
+static void usage(const char *program) {
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  --sessions N  seeded sessions to run (default: %d)\n"
+            "  --frames N    frames per seeded session (default: %d)\n"
+            "  --seed N      seed of the seeded sessions (default: 0)\n"
+            "  --replay FILE also run a replay (or a disk holding one) and check it\n"
+            "                ends in its recorded state, can be given up to %d times\n"
+            "  --threads N   worker threads (default: one per core)\n",
+            program, DEFAULT_SESSIONS, DEFAULT_SESSION_FRAMES, MAX_REPLAYS);
+}
+
+int main(int argc, char **argv) {
+    static Batch batch = {
+        .num_sessions=DEFAULT_SESSIONS,
+        .session_frames=DEFAULT_SESSION_FRAMES,
+    };
+    long num_threads = sysconf(_SC_NPROCESSORS_ONLN);
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (strcmp(arg, "--sessions") == 0 && has_value) {
+            batch.num_sessions = (uint32_t) strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(arg, "--frames") == 0 && has_value) {
+            batch.session_frames = strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(arg, "--seed") == 0 && has_value) {
+            batch.seed = (uint32_t) strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(arg, "--replay") == 0 && has_value &&
+                   batch.num_replays < MAX_REPLAYS) {
+            const Replay_Header *replay = replay_load(argv[++i]);
+            if (!replay) {
+                return 1;
+            }
+            batch.replays[batch.num_replays++] = replay;
+        } else if (strcmp(arg, "--threads") == 0 && has_value) {
+            num_threads = strtol(argv[++i], NULL, 10);
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (num_threads < 1) {
+        num_threads = 1;
+    }
+    if (num_threads > MAX_THREADS) {
+        num_threads = MAX_THREADS;
+    }
+    batch.num_threads = (int) num_threads;
+
+    uint32_t total = batch.num_sessions + batch.num_replays;
+    batch.results = calloc(total ? total : 1, sizeof(*batch.results));
+    if (!batch.results) {
+        fprintf(stderr, "ERROR: Out of memory\n");
+        return 1;
+    }
+    for (int i = 0; i < batch.num_threads; i++) {
+        Work_Queue *queue = &batch.queues[i];
+        pthread_mutex_init(&queue->lock, NULL);
+        queue->begin = (uint32_t) ((uint64_t) total * (uint32_t) i / (uint32_t) batch.num_threads);
+        queue->end = (uint32_t) ((uint64_t) total * (uint32_t) (i + 1) / (uint32_t) batch.num_threads);
+    }
+
+    static Worker workers[MAX_THREADS];
+    pthread_t threads[MAX_THREADS];
+    uint64_t begin = now_ns();
+    for (int i = 0; i < batch.num_threads; i++) {
+        workers[i] = (Worker) {.batch=&batch, .index=i};
+        if (pthread_create(&threads[i], NULL, run_worker, &workers[i]) != 0) {
+            fprintf(stderr, "ERROR: Could not start a thread\n");
+            return 1;
+        }
+    }
+    unsigned long steals = 0;
+    for (int i = 0; i < batch.num_threads; i++) {
+        pthread_join(threads[i], NULL);
+        steals += workers[i].steals;
+    }
+    uint64_t elapsed = now_ns() - begin;
+
+    unsigned long frames = 0;
+    unsigned long clears = 0;
+    unsigned long losses = 0;
+    unsigned long screens[NUM_SCREEN] = {0};
+    unsigned long matched = 0;
+    unsigned long diverged = 0;
+    Level deepest = 0;
+    uint32_t checksum = HASH_SEED;
+    for (uint32_t i = 0; i < total; i++) {
+        const Session_Result *result = &batch.results[i];
+        frames += result->frames;
+        clears += result->clears;
+        losses += result->losses;
+        screens[result->screen_kind]++;
+        matched += result->replay_result == REPLAY_MATCHED;
+        diverged += result->replay_result == REPLAY_DIVERGED;
+        deepest = result->level > deepest ? result->level : deepest;
+        checksum = hash_bytes(checksum, &result->checksum, sizeof(result->checksum));
+    }
+
+    double seconds = (double) elapsed / 1e9;
+    printf("sessions=%u threads=%d steals=%lu frames=%lu seconds=%.3f frames_per_sec=%.0f\n",
+           total, batch.num_threads, steals, frames, seconds,
+           seconds > 0 ? (double) frames / seconds : 0.0);
+    printf("clears=%lu losses=%lu deepest_level=%d ended_on_help=%lu ended_in_game=%lu "
+           "ended_on_game_over=%lu\n",
+           clears, losses, deepest, screens[HELP_SCREEN], screens[GAME_SCREEN],
+           screens[GAME_OVER_SCREEN]);
+    if (batch.num_replays > 0) {
+        printf("replays_matched=%lu replays_diverged=%lu\n", matched, diverged);
+    }
+    printf("checksum=%08x\n", checksum);
+
+    free(batch.results);
+    return diverged > 0 ? 1 : 0;
+}
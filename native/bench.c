@@ -0,0 +1,296 @@
+// Frame-time benchmark for update().
+//
+// Runs every screen (and GAME_SCREEN at every level with the ball in
+// play, in multi-ball mode with a fixed number of balls, in turbo
+// to check that drawing costs the same however many ticks run, and in
+// arenas of 48 to 10000 bricks to check that neither collisions nor
+// drawing cost more the bigger the arena, and with the particle pool
+// kept full and recycling to check what thousands of particles cost)
+// for a fixed number of frames on the software runtime, then
+// prints one CSV row per scenario: ns/frame percentiles, host calls
+// per frame and framebuffer bytes written per frame. Call counts and
+// bytes are deterministic, so diffing two runs shows regressions in
+// the amount of work even when timings are noisy.
+#include "main.c"
+
+#include "w4_runtime.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define DEFAULT_BENCH_FRAMES 20000
+
+typedef struct {
+    const char *name;
+    Screen_Kind screen_kind;
+    Level level;
+    // Multi-ball mode with the pool kept at this many balls, 0 for
+    // the normal single ball game
+    int num_balls;
+    // Game ticks per frame
+    int ticks_per_frame;
+    // Bricks of the arena played, 0 for the level's
+    int arena_bricks;
+    // Particles spawned each frame (in bursts on top of those of broken
+    // bricks) into a pool of 8 times that, which keeps it full: past
+    // PARTICLE_CAPACITY the pool is given more room
+    int particles_per_frame;
+} Bench_Scenario;
+
+// Levels are in the order of levels/*.txt
+_Static_assert(NUM_LEVELS >= 8, "The benchmark plays the first 8 levels");
+
+static const Bench_Scenario scenarios[] = {
+    {"help",                 HELP_SCREEN,      0, 0,    1, 0, 0},
+    {"game_over",            GAME_OVER_SCREEN, 0, 0,    1, 0, 0},
+    {"game_level1",          GAME_SCREEN,      0, 0,    1, 0, 0},
+    {"game_level2",          GAME_SCREEN,      1, 0,    1, 0, 0},
+    {"game_level3",          GAME_SCREEN,      2, 0,    1, 0, 0},
+    {"game_level4",          GAME_SCREEN,      3, 0,    1, 0, 0},
+    {"game_level5",          GAME_SCREEN,      4, 0,    1, 0, 0},
+    {"game_level6",          GAME_SCREEN,      5, 0,    1, 0, 0},
+    {"game_level7",          GAME_SCREEN,      6, 0,    1, 0, 0},
+    {"game_level8",          GAME_SCREEN,      7, 0,    1, 0, 0},
+    {"multiball_1",          GAME_SCREEN,      7, 1,    1, 0, 0},
+    {"multiball_16",         GAME_SCREEN,      7, 16,   1, 0, 0},
+    {"multiball_256",        GAME_SCREEN,      7, 256,  1, 0, 0},
+    {"multiball_1024",       GAME_SCREEN,      7, 1024, 1, 0, 0},
+    {"turbo8_level8",        GAME_SCREEN,      7, 0,    8, 0, 0},
+    {"turbo8_multiball_256", GAME_SCREEN,      7, 256,  8, 0, 0},
+    {"arena_48",             GAME_SCREEN,      7, 0,    1, 48, 0},
+    {"arena_480",            GAME_SCREEN,      7, 0,    1, 480, 0},
+    {"arena_2400",           GAME_SCREEN,      7, 0,    1, 2400, 0},
+    {"arena_10000",          GAME_SCREEN,      7, 0,    1, 10000, 0},
+    {"arena_10000_multiball_256", GAME_SCREEN, 7, 256,  1, 10000, 0},
+    {"particles_2048",       GAME_SCREEN,      7, 0,    1, 0, 256},
+    {"particles_8192",       GAME_SCREEN,      7, 0,    1, 0, 1024},
+};
+
+typedef struct {
+    uint64_t rect;
+    uint64_t vline;
+    uint64_t hline;
+    uint64_t text;
+    uint64_t blit;
+    uint64_t tone;
+    uint64_t framebuffer_bytes;
+    uint64_t commands_recorded;
+    uint64_t commands_submitted;
+    uint64_t draw_colors_changes;
+} Bench_Totals;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+}
+
+static int compare_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *) a;
+    uint64_t y = *(const uint64_t *) b;
+    return (x > y) - (x < y);
+}
+
+static uint64_t percentile(const uint64_t *sorted, unsigned long count, int pct) {
+    unsigned long idx = (count * (unsigned long) pct) / 100;
+    return sorted[idx < count ? idx : count - 1];
+}
+
+static void enter_scenario(const Bench_Scenario *scenario) {
+    state.level = scenario->level;
+    state.game_mode = scenario->num_balls > 0 ? MULTI_BALL_MODE : SINGLE_BALL_MODE;
+    state.arena = scenario->arena_bricks > 0;
+    if (state.arena) {
+        state.arena_num_bricks = (uint16_t) scenario->arena_bricks;
+    }
+    reset_level(&state);
+    state.screen_kind = scenario->screen_kind;
+    state.previous_gamepad = 0;
+    renderer.events.full_repaint = true;
+}
+
+// Keeps the paddle under the ball and relaunches it whenever it rests
+// on the paddle, so GAME_SCREEN scenarios measure a ball in play. The
+// aim point drifts and the paddle moves at contact so the ball sweeps
+// across the brick field.
+static uint8_t bench_input(unsigned long frame) {
+    if (state.screen_kind != GAME_SCREEN) {
+        return 0;
+    }
+    const Ball_Pool *balls = &state.balls;
+    if (ball_resting(balls)) {
+        return state.previous_gamepad & BUTTON_2 ? 0 : BUTTON_2;
+    }
+    if (balls->velocity_y[0] > 0 && fixed_floor(balls->y[0]) + BALL_DIAMETER >= PADDLE_Y - 3) {
+        // Moving at contact puts spin on the ball
+        return (frame / 700) % 2 ? BUTTON_LEFT : BUTTON_RIGHT;
+    }
+    int aim = (int) ((frame / 500) % 5) * 6 - 12;
+    int paddle_center = state.paddle_x + (PADDLE_WIDTH >> 1) + aim;
+    int ball_center = fixed_floor(balls->x[0]) + (BALL_DIAMETER >> 1);
+    if (ball_center < paddle_center - 4) {
+        return BUTTON_LEFT;
+    }
+    if (ball_center > paddle_center + 4) {
+        return BUTTON_RIGHT;
+    }
+    return 0;
+}
+
+// Tops the pool up to (or trims it down to) the scenario's ball count.
+// New balls are scattered below the bricks, half of them going up.
+static void keep_num_balls(int num_balls, unsigned long *spawned) {
+    Ball_Pool *balls = &state.balls;
+    while (balls->count > num_balls) {
+        remove_ball(balls, balls->count - 1);
+    }
+    while (balls->count < num_balls) {
+        unsigned long k = (*spawned)++;
+        spawn_ball(balls,
+                   4 + (int) ((k * 37) % (SCREEN_SIZE - 12)),
+                   70 + (int) ((k * 53) % 60),
+                   (int) (k % 5) * (FIXED_ONE >> 1) - FIXED_ONE,
+                   k & 1 ? -FIXED_ONE : FIXED_ONE);
+    }
+}
+
+// Bursts of particles all over the screen, as if that many bricks had
+// just broken
+static void keep_particles_spawning(int num_particles, unsigned long frame) {
+    for (int n = 0; n < num_particles; n += PARTICLES_PER_BRICK) {
+        unsigned long k = frame * 31 + (unsigned long) n;
+        Rect r = {
+            .x=(int) ((k * 37) % (SCREEN_SIZE - BRICK_WIDTH)),
+            .y=(int) ((k * 53) % (SCREEN_SIZE - BRICK_HEIGHT)),
+            .width=BRICK_WIDTH,
+            .height=BRICK_HEIGHT,
+        };
+        int burst = num_particles - n;
+        spawn_particle_burst(&particles, r, burst < PARTICLES_PER_BRICK ? burst : PARTICLES_PER_BRICK);
+    }
+}
+
+static void run_scenario(const Bench_Scenario *scenario, unsigned long num_frames,
+                         uint64_t *samples) {
+    w4_runtime_init(NULL);
+    w4_runtime_set_trace_enabled(false);
+    start();
+    attract.enabled = false;
+    int particle_capacity = 8 * scenario->particles_per_frame;
+    void *particle_room = NULL;
+    if (particle_capacity > PARTICLE_CAPACITY) {
+        particle_room = malloc((size_t) particle_capacity * PARTICLE_BYTES);
+        if (!particle_room) {
+            fprintf(stderr, "ERROR: Out of memory\n");
+            exit(1);
+        }
+        particles_init(&particles, particle_room, (uint16_t) particle_capacity);
+    }
+    timestep_set_scale(&timestep, int_to_fixed(scenario->ticks_per_frame));
+    enter_scenario(scenario);
+
+    Bench_Totals totals = {0};
+    unsigned long restarts = 0;
+    unsigned long spawned = 0;
+    for (unsigned long frame = 0; frame < num_frames; frame++) {
+        if (state.screen_kind != scenario->screen_kind) {
+            // Level cleared or lost, start it over
+            enter_scenario(scenario);
+            restarts++;
+        }
+        if (scenario->num_balls > 0) {
+            keep_num_balls(scenario->num_balls, &spawned);
+        }
+        w4_runtime_set_gamepad(0, bench_input(frame));
+        w4_runtime_take_stats();
+
+        uint64_t begin = now_ns();
+        if (scenario->particles_per_frame > 0) {
+            keep_particles_spawning(scenario->particles_per_frame, frame);
+        }
+        w4_runtime_begin_frame();
+        update();
+        samples[frame] = now_ns() - begin;
+
+        W4_Host_Stats stats = w4_runtime_take_stats();
+        totals.rect += stats.rect;
+        totals.vline += stats.vline;
+        totals.hline += stats.hline;
+        totals.text += stats.text;
+        totals.blit += stats.blit;
+        totals.tone += stats.tone;
+        totals.framebuffer_bytes += stats.framebuffer_bytes;
+        totals.commands_recorded += renderer.commands.stats.commands_recorded;
+        totals.commands_submitted += renderer.commands.stats.commands_submitted;
+        totals.draw_colors_changes += renderer.commands.stats.draw_colors_changes;
+    }
+
+    particles_init(&particles, particle_storage, PARTICLE_CAPACITY);
+    free(particle_room);
+
+    uint64_t sum = 0;
+    for (unsigned long frame = 0; frame < num_frames; frame++) {
+        sum += samples[frame];
+    }
+    qsort(samples, num_frames, sizeof(samples[0]), compare_u64);
+
+    double n = (double) num_frames;
+    printf("%s,%lu,%lu,%.1f,%llu,%llu,%llu,%llu,%.2f,%.2f,%.2f,%.2f,%.2f,%.4f,%.1f,"
+           "%.2f,%.2f,%.2f\n",
+           scenario->name, num_frames, restarts,
+           (double) sum / n,
+           (unsigned long long) percentile(samples, num_frames, 50),
+           (unsigned long long) percentile(samples, num_frames, 90),
+           (unsigned long long) percentile(samples, num_frames, 99),
+           (unsigned long long) samples[num_frames - 1],
+           (double) totals.rect / n, (double) totals.vline / n,
+           (double) totals.hline / n, (double) totals.text / n,
+           (double) totals.blit / n, (double) totals.tone / n,
+           (double) totals.framebuffer_bytes / n,
+           (double) totals.commands_recorded / n, (double) totals.commands_submitted / n,
+           (double) totals.draw_colors_changes / n);
+}
+
+int main(int argc, char **argv) {
+    unsigned long num_frames = DEFAULT_BENCH_FRAMES;
+    const char *only = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            num_frames = strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--scenario") == 0 && i + 1 < argc) {
+            only = argv[++i];
+        } else {
+            fprintf(stderr,
+                    "Usage: %s [--frames N] [--scenario NAME]\n"
+                    "Prints one CSV row per scenario on stdout.\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+    if (num_frames == 0) {
+        fprintf(stderr, "ERROR: --frames must be positive\n");
+        return 2;
+    }
+
+    uint64_t *samples = malloc(num_frames * sizeof(*samples));
+    if (!samples) {
+        fprintf(stderr, "ERROR: Out of memory\n");
+        return 1;
+    }
+
+    printf("scenario,frames,restarts,ns_mean,ns_p50,ns_p90,ns_p99,ns_max,"
+           "rect,vline,hline,text,blit,tone,fb_bytes,cmds_recorded,cmds_submitted,"
+           "draw_colors_changes\n");
+    for (size_t i = 0; i < ARRAY_LEN(scenarios); i++) {
+        if (only && strcmp(only, scenarios[i].name) != 0) {
+            continue;
+        }
+        run_scenario(&scenarios[i], num_frames, samples);
+    }
+
+    free(samples);
+    return 0;
+}
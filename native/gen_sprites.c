@@ -0,0 +1,120 @@
+// Generates the cart's sprites (build/gen/sprites.h).
+//
+// Sprites are 2bpp and drawn with SPRITE_DRAW_COLORS: pixel value 0 is
+// transparent and values 1-3 are palette colors 2-4. Sprites that are
+// laid out next to each other on screen (bricks in a row, the lives
+// HUD) are stored the same way in the sprite, transparent gaps
+// included, so neighbors can be drawn with a single blit. They are
+// also at the same x as on screen (modulo 4 at least), so the sprite
+// bytes line up with the framebuffer bytes and the rasterizer can
+// draw them a byte at a time.
+//
+// brick_atlas: one row of NUM_BRICK_COLS bricks per health level. A
+// brick is filled with color 3 with a vertical bar of color 4 per
+// health point on its left side.
+//
+// ball_strip: NUM_BALL_STRIP_CELLS balls (color 3 with a color 4
+// border) one pixel apart, laid out like the lives HUD.
+#include "balls.h"
+#include "bricks.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define TRANSPARENT      0
+#define BRICK_BODY_COLOR 3
+#define BRICK_BAR_COLOR  4
+#define BALL_FILL_COLOR  3
+#define BALL_EDGE_COLOR  4
+
+#define NUM_BALL_STRIP_CELLS 8
+
+#define BRICK_ATLAS_WIDTH  SCREEN_SIZE
+#define BRICK_ATLAS_HEIGHT (MAX_BRICK_HEALTH * (BRICK_HEIGHT))
+// Rounded up to whole bytes
+#define BALL_STRIP_WIDTH   ((LIVES_X + NUM_BALL_STRIP_CELLS * (BALL_DIAMETER + 1) + 3) & ~0x3)
+#define BALL_STRIP_HEIGHT  BALL_DIAMETER
+
+static uint8_t brick_atlas[BRICK_ATLAS_WIDTH * BRICK_ATLAS_HEIGHT / 4];
+static uint8_t ball_strip[BALL_STRIP_WIDTH * BALL_STRIP_HEIGHT / 4];
+
+static void set_pixel(uint8_t *sprite, int stride, int x, int y, int color) {
+    if (color == TRANSPARENT) {
+        return;
+    }
+    int bit_index = y * stride + x;
+    int shift = 6 - ((bit_index & 0x3) << 1);
+    sprite[bit_index >> 2] |= (uint8_t) ((color - 1) << shift);
+}
+
+static void print_sprite(const char *name, const uint8_t *sprite, size_t size) {
+    printf("static const uint8_t %s[%d] = {", name, (int) size);
+    for (size_t i = 0; i < size; i++) {
+        printf("%s0x%02x,", i % 12 == 0 ? "\n    " : " ", sprite[i]);
+    }
+    printf("\n};\n");
+}
+
+int main(void) {
+    _Static_assert(BRICK_ATLAS_WIDTH * BRICK_ATLAS_HEIGHT % 4 == 0,
+                   "The brick atlas must fill whole bytes");
+    _Static_assert(BALL_STRIP_WIDTH * BALL_STRIP_HEIGHT % 4 == 0,
+                   "The ball strip must fill whole bytes");
+    _Static_assert(BRICK_PAD + BRICK_INITIAL_X + NUM_BRICK_COLS * BRICK_WIDTH_PLUS_PADDING <=
+                   BRICK_ATLAS_WIDTH,
+                   "The brick atlas is too narrow for a row of bricks");
+    _Static_assert(MAX_BRICK_HEALTH <= (BRICK_WIDTH),
+                   "A brick is too narrow for a bar per health point");
+
+    for (int health = 1; health <= MAX_BRICK_HEALTH; health++) {
+        int frame_y = (health - 1) * (BRICK_HEIGHT);
+        for (int y = 0; y < (BRICK_HEIGHT); y++) {
+            for (int x = brick_col_x(0); x < brick_col_x(NUM_BRICK_COLS); x++) {
+                int brick_x = (x - brick_col_x(0)) % BRICK_WIDTH_PLUS_PADDING;
+                int color = brick_x >= (BRICK_WIDTH) ? TRANSPARENT
+                          : brick_x < health         ? BRICK_BAR_COLOR
+                          :                            BRICK_BODY_COLOR;
+                set_pixel(brick_atlas, BRICK_ATLAS_WIDTH, x, frame_y + y, color);
+            }
+        }
+    }
+
+    for (int y = 0; y < BALL_STRIP_HEIGHT; y++) {
+        for (int x = LIVES_X; x < LIVES_X + NUM_BALL_STRIP_CELLS * (BALL_DIAMETER + 1); x++) {
+            int ball_x = (x - LIVES_X) % (BALL_DIAMETER + 1);
+            bool edge = ball_x == 0 || ball_x == BALL_DIAMETER - 1 ||
+                        y == 0 || y == BALL_DIAMETER - 1;
+            int color = ball_x == BALL_DIAMETER ? TRANSPARENT
+                      : edge                    ? BALL_EDGE_COLOR
+                      :                           BALL_FILL_COLOR;
+            set_pixel(ball_strip, BALL_STRIP_WIDTH, x, y, color);
+        }
+    }
+
+    printf("// Generated by native/gen_sprites.c, do not edit\n"
+           "#ifndef SPRITES_H_\n"
+           "#define SPRITES_H_\n"
+           "\n"
+           "#include <stdint.h>\n"
+           "\n"
+           "#define SPRITE_DRAW_COLORS   0x4320\n"
+           "#define SPRITE_FLAGS         BLIT_2BPP\n"
+           "\n"
+           "#define BRICK_ATLAS_WIDTH    %d\n"
+           "#define BRICK_ATLAS_HEIGHT   %d\n"
+           "#define BALL_STRIP_WIDTH     %d\n"
+           "#define BALL_STRIP_HEIGHT    %d\n"
+           "#define NUM_BALL_STRIP_CELLS %d\n"
+           "\n"
+           "// Bricks of health h are in rows [(h - 1) * BRICK_HEIGHT, h * BRICK_HEIGHT),\n"
+           "// the one in column c at x = brick_col_x(c)\n",
+           BRICK_ATLAS_WIDTH, BRICK_ATLAS_HEIGHT,
+           BALL_STRIP_WIDTH, BALL_STRIP_HEIGHT, NUM_BALL_STRIP_CELLS);
+    print_sprite("brick_atlas", brick_atlas, sizeof(brick_atlas));
+    printf("\n"
+           "// Ball i is at x = LIVES_X + i * (BALL_DIAMETER + 1)\n");
+    print_sprite("ball_strip", ball_strip, sizeof(ball_strip));
+    printf("\n"
+           "#endif\n");
+    return 0;
+}
@@ -0,0 +1,234 @@
+// Headless native runner: drives start()/update() from a scripted
+// input stream (or a replay, see src/replay.h, or the autoplayer) at
+// full CPU speed on the software WASM-4 runtime.
+//
+// The cart is compiled into this translation unit so that native
+// tools can reach the game state directly.
+#include "main.c"
+
+#include "input_script.h"
+#include "replay_file.h"
+#include "w4_runtime.h"
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static Input_Script script;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+}
+
+static void usage(const char *program) {
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  --frames N         number of frames to run (default: 600)\n"
+            "  --input FILE       scripted GAMEPAD1 input (see native/input_script.h)\n"
+            "  --loop             repeat the input script when it runs out\n"
+            "  --disk FILE        file backing diskr()/diskw()\n"
+            "  --screenshot FILE  write the last frame as a PPM image\n"
+            "  --record FILE      write the session as a replay\n"
+            "  --replay FILE      play a replay (or a disk holding one) instead of\n"
+            "                     --input, for as many frames as it has, and check\n"
+            "                     that it ends in the recorded state\n"
+            "  --bot              the autoplayer presses the buttons instead of --input\n"
+            "  --bot2             the autoplayer joins as player 2 (GAMEPAD2) for\n"
+            "                     a versus game\n"
+            "  --seed N           seed of the generated levels of endless mode\n"
+            "  --arena N          switch to an arena of N bricks (up to %d) on the\n"
+            "                     first frame, pressing up with down held\n"
+            "  --speed X          game ticks per frame, 0.125 to 8 (default: 1)\n"
+            "  --drop N           skip update() every Nth frame, as a host that\n"
+            "                     can't keep up would, the next frame catches up\n"
+            "  --counters FILE    write the hot path counters of every frame as CSV\n"
+            "                     (DEBUG=1 builds only, see src/perf_counters.h)\n"
+            "  --quiet            silence trace()/tracef()\n",
+            program, ARENA_MAX_BRICKS);
+}
+
+int main(int argc, char **argv) {
+    unsigned long num_frames = 600;
+    const char *input_path = NULL;
+    const char *disk_path = NULL;
+    const char *screenshot_path = NULL;
+    const char *record_path = NULL;
+    const char *replay_path = NULL;
+    const char *counters_path = NULL;
+    bool bot = false;
+    bool bot2 = false;
+    bool quiet = false;
+    double speed = 1;
+    unsigned long drop_every = 0;
+    bool arena = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (strcmp(arg, "--frames") == 0 && has_value) {
+            num_frames = strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(arg, "--input") == 0 && has_value) {
+            input_path = argv[++i];
+        } else if (strcmp(arg, "--loop") == 0) {
+            script.loop = true;
+        } else if (strcmp(arg, "--disk") == 0 && has_value) {
+            disk_path = argv[++i];
+        } else if (strcmp(arg, "--screenshot") == 0 && has_value) {
+            screenshot_path = argv[++i];
+        } else if (strcmp(arg, "--record") == 0 && has_value) {
+            record_path = argv[++i];
+        } else if (strcmp(arg, "--replay") == 0 && has_value) {
+            replay_path = argv[++i];
+        } else if (strcmp(arg, "--bot") == 0) {
+            bot = true;
+        } else if (strcmp(arg, "--bot2") == 0) {
+            bot2 = true;
+        } else if (strcmp(arg, "--seed") == 0 && has_value) {
+            endless_seed = (uint32_t) strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(arg, "--arena") == 0 && has_value) {
+            arena_num_bricks = atoi(argv[++i]);
+            arena = true;
+        } else if (strcmp(arg, "--speed") == 0 && has_value) {
+            speed = strtod(argv[++i], NULL);
+        } else if (strcmp(arg, "--drop") == 0 && has_value) {
+            drop_every = strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(arg, "--counters") == 0 && has_value) {
+            counters_path = argv[++i];
+        } else if (strcmp(arg, "--quiet") == 0) {
+            quiet = true;
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (arena && (arena_num_bricks < 1 || arena_num_bricks > ARENA_MAX_BRICKS)) {
+        fprintf(stderr, "ERROR: --arena must be 1 to %d\n", ARENA_MAX_BRICKS);
+        return 2;
+    }
+
+    FILE *counters = NULL;
+    if (counters_path) {
+#ifdef DEBUG
+        counters = fopen(counters_path, "w");
+        if (!counters) {
+            fprintf(stderr, "ERROR: Could not write %s\n", counters_path);
+            return 1;
+        }
+        fprintf(counters, "frame");
+        for (int c = 0; c < NUM_PERF_COUNTERS; c++) {
+            fprintf(counters, ",%s", perf_counter_names[c]);
+        }
+        fprintf(counters, "\n");
+#else
+        fprintf(stderr, "ERROR: --counters needs a DEBUG=1 build\n");
+        return 2;
+#endif
+    }
+
+    w4_runtime_init(disk_path);
+    w4_runtime_set_trace_enabled(!quiet);
+    if (input_path && !input_script_load(&script, input_path)) {
+        return 1;
+    }
+
+    Replay_Header *replay = NULL;
+    if (replay_path) {
+        replay = replay_load(replay_path);
+        if (!replay) {
+            return 1;
+        }
+        num_frames = replay->num_frames;
+    }
+    if (record_path) {
+        // Room for a run per tick, so the whole session fits
+        unsigned long num_ticks = num_frames;
+        if (speed > 1 || drop_every > 0) {
+            num_ticks *= MAX_TICKS_PER_FRAME;
+        }
+        if (num_ticks <= UINT32_MAX) {
+            replays.recording = malloc(sizeof(Replay_Header) + num_ticks * sizeof(Replay_Run));
+            replays.recording_capacity = (uint32_t) num_ticks;
+        }
+        if (!replays.recording || num_ticks > UINT32_MAX) {
+            fprintf(stderr, "ERROR: Out of memory\n");
+            return 1;
+        }
+    }
+
+    start();
+    if (record_path && !replays.recording_on) {
+        fprintf(stderr, "ERROR: The session resumed from the save state on the disk, "
+                        "only fresh games can be recorded\n");
+        return 1;
+    }
+    if (replay_path) {
+        start_replay(replay, (const Replay_Run *) (replay + 1));
+    }
+    timestep_set_scale(&timestep, (Fixed) (speed * FIXED_ONE));
+
+    uint64_t begin = now_ns();
+    unsigned long frame = 0;
+    // A replay goes on for as many frames as its ticks take at this speed
+    for (; replay ? replays.playing : frame < num_frames; frame++) {
+        uint8_t gamepad = 0;
+        if (bot) {
+            gamepad = autoplayer_input(&state);
+        } else if (!replay) {
+            gamepad = input_script_next(&script);
+        }
+        if (arena && frame == 0) {
+            gamepad = BUTTON_DOWN | BUTTON_UP;
+        }
+        if (drop_every > 0 && (frame + 1) % drop_every == 0) {
+            timestep_catch_up(&timestep, 1);
+            continue;
+        }
+        w4_runtime_set_gamepad(0, gamepad);
+        w4_runtime_set_gamepad(1, bot2 ? autoplayer_player_input(&state, 1) : 0);
+        w4_runtime_begin_frame();
+        update();
+#ifdef DEBUG
+        if (counters) {
+            const uint32_t *counts = perf_last_frame();
+            fprintf(counters, "%lu", frame);
+            for (int c = 0; c < NUM_PERF_COUNTERS; c++) {
+                fprintf(counters, ",%u", counts[c]);
+            }
+            fprintf(counters, "\n");
+        }
+#endif
+    }
+    uint64_t elapsed = now_ns() - begin;
+
+    if (counters && fclose(counters) != 0) {
+        fprintf(stderr, "ERROR: Could not write %s\n", counters_path);
+        return 1;
+    }
+
+    if (record_path) {
+        seal_recording();
+        if (!replay_save(replays.recording, record_path)) {
+            fprintf(stderr, "ERROR: Could not write %s\n", record_path);
+            return 1;
+        }
+    }
+
+    if (screenshot_path && !w4_runtime_save_screenshot(screenshot_path)) {
+        fprintf(stderr, "ERROR: Could not write %s\n", screenshot_path);
+        return 1;
+    }
+
+    printf("frames=%lu total_ns=%llu ns_per_frame=%.1f\n",
+           frame, (unsigned long long) elapsed,
+           frame ? (double) elapsed / (double) frame : 0.0);
+    if (replay) {
+        bool matched = replays.result == REPLAY_MATCHED;
+        printf("replay=%s\n", matched ? "matched" : "diverged");
+        return matched ? 0 : 1;
+    }
+    return 0;
+}
@@ -0,0 +1,90 @@
+#include "input_script.h"
+#include "wasm4.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+bool input_parse_buttons(const char *str, uint8_t *buttons) {
+    uint8_t result = 0;
+    for (; *str; str++) {
+        switch (*str) {
+        case '.': break;
+        case '1': result |= BUTTON_1; break;
+        case '2': result |= BUTTON_2; break;
+        case 'L': result |= BUTTON_LEFT; break;
+        case 'R': result |= BUTTON_RIGHT; break;
+        case 'U': result |= BUTTON_UP; break;
+        case 'D': result |= BUTTON_DOWN; break;
+        default:
+            return false;
+        }
+    }
+    *buttons = result;
+    return true;
+}
+
+bool input_script_load(Input_Script *script, const char *path) {
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        tracef("ERROR: Could not open input script %s", path);
+        return false;
+    }
+
+    script->num_steps = 0;
+    script->step = 0;
+    script->frame_in_step = 0;
+
+    char line[256];
+    int line_number = 0;
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), file)) {
+        line_number++;
+        char *comment = strchr(line, '#');
+        if (comment) {
+            *comment = '\0';
+        }
+
+        char buttons_str[64];
+        unsigned long frames;
+        int fields = sscanf(line, "%lu %63s", &frames, buttons_str);
+        if (fields <= 0) {
+            continue;
+        }
+
+        Input_Step step = {0};
+        if (fields != 2 || frames == 0 ||
+            !input_parse_buttons(buttons_str, &step.buttons)) {
+            tracef("ERROR: %s:%d: expected `<frames> <buttons>`", path, line_number);
+            ok = false;
+            break;
+        }
+        if (script->num_steps == INPUT_SCRIPT_MAX_STEPS) {
+            tracef("ERROR: %s: more than %d steps", path, INPUT_SCRIPT_MAX_STEPS);
+            ok = false;
+            break;
+        }
+        step.frames = (uint32_t) frames;
+        script->steps[script->num_steps++] = step;
+    }
+
+    fclose(file);
+    return ok;
+}
+
+uint8_t input_script_next(Input_Script *script) {
+    if (script->step >= script->num_steps) {
+        if (!script->loop || script->num_steps == 0) {
+            return 0;
+        }
+        script->step = 0;
+    }
+
+    Input_Step *step = &script->steps[script->step];
+    uint8_t buttons = step->buttons;
+    if (++script->frame_in_step >= step->frames) {
+        script->frame_in_step = 0;
+        script->step++;
+    }
+    return buttons;
+}
@@ -0,0 +1,46 @@
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifndef INPUT_SCRIPT_H_
+#define INPUT_SCRIPT_H_
+
+// Scripted GAMEPAD1 input for headless runs.
+//
+// A script is a text file with one step per line:
+//   <frames> <buttons>
+// where buttons is "." for none or any combination of
+//   1 2 L R U D   (BUTTON_1, BUTTON_2, LEFT, RIGHT, UP, DOWN)
+// Everything after a '#' is a comment.
+//
+//   # open the game, launch the ball and hold right for half a second
+//   1  U
+//   1  2
+//   30 R
+
+#define INPUT_SCRIPT_MAX_STEPS 4096
+
+typedef struct {
+    uint32_t frames;
+    uint8_t buttons;
+} Input_Step;
+
+typedef struct {
+    Input_Step steps[INPUT_SCRIPT_MAX_STEPS];
+    uint32_t num_steps;
+    uint32_t step;
+    uint32_t frame_in_step;
+    bool loop;
+} Input_Script;
+
+// Parses a button string ("." or e.g. "2R") into a gamepad byte,
+// returns false on unknown characters
+bool input_parse_buttons(const char *str, uint8_t *buttons);
+
+// Loads a script from path, returns false (and traces why) on error
+bool input_script_load(Input_Script *script, const char *path);
+
+// Returns the gamepad byte for the next frame and advances the script.
+// Once the script runs out it returns 0, or starts over if loop is set.
+uint8_t input_script_next(Input_Script *script);
+
+#endif
@@ -0,0 +1,197 @@
+// Compiles the level files given on the command line, in that order,
+// into the cart's level pack (build/gen/levels.h).
+//
+// A level file has one setting per line, then the bricks:
+//
+//   # Comments start with '#'
+//   balls 4           # lives, 1-255
+//   speed 5           # vertical ball speed, in quarter pixels per frame
+//   fall 300 0        # frames per fall clock cycle (0: the bricks never
+//                     # fall) and how many frames shorter each cycle gets
+//   bricks
+//   333333            # NUM_BRICK_ROWS rows of NUM_BRICK_COLS bricks,
+//   3.33.3 4 1        # their health in hex (1-f) or '.' for no brick,
+//   ...               # optionally followed by the row's fall delay in
+//                     # cycles (0-255) and shift (0-7, it falls a pixel
+//                     # every 2^shift cycles)
+//
+// balls and speed default to 3 and 4, fall to 0 0.
+//
+// Levels are packed as described in src/level_format.h, a level
+// usually takes less than 10 bytes.
+#include "level_format.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_PACK_SIZE UINT16_MAX
+
+static uint8_t pack[MAX_PACK_SIZE];
+
+// Prints where and why a level file is wrong, for the error return paths
+static bool level_error(const char *path, int line, const char *message) {
+    fprintf(stderr, "%s:%d: ERROR: %s\n", path, line, message);
+    return false;
+}
+
+static int hex_health(char c) {
+    if (c >= '1' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+static bool parse_level(const char *path, Level_Source *level) {
+    FILE *in = fopen(path, "r");
+    if (!in) {
+        fprintf(stderr, "ERROR: Could not open %s\n", path);
+        return false;
+    }
+    *level = (Level_Source) {.num_balls=3, .ball_speed=4};
+
+    char line[256];
+    int line_number = 0;
+    int row = -1;
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), in)) {
+        line_number++;
+        char *comment = strchr(line, '#');
+        if (comment) {
+            *comment = '\0';
+        }
+        char word[64];
+        int consumed = 0;
+        if (sscanf(line, "%63s%n", word, &consumed) != 1) {
+            continue;
+        }
+        const char *rest = line + consumed;
+        char extra[2];
+
+        if (row >= 0) {
+            if (row == NUM_BRICK_ROWS) {
+                ok = level_error(path, line_number, "More rows than NUM_BRICK_ROWS");
+                break;
+            }
+            if (strlen(word) != (size_t) NUM_BRICK_COLS) {
+                ok = level_error(path, line_number, "A row must have NUM_BRICK_COLS bricks");
+                break;
+            }
+            for (int col = 0; col < NUM_BRICK_COLS; col++) {
+                int health = word[col] == '.' ? 0 : hex_health(word[col]);
+                if (health < 0 || health > MAX_BRICK_HEALTH) {
+                    ok = level_error(path, line_number, "A brick is '.' or a health of 1-f");
+                    break;
+                }
+                level->health[row * NUM_BRICK_COLS + col] = (uint8_t) health;
+            }
+            if (!ok) {
+                break;
+            }
+            unsigned delay = 0;
+            unsigned shift = 0;
+            int fields = sscanf(rest, "%u %u %1s", &delay, &shift, extra);
+            if (fields == 1 || fields == 3 || delay > 255 || shift > 7 ||
+                (fields <= 0 && sscanf(rest, "%1s", extra) == 1)) {
+                ok = level_error(path, line_number, "A row's fall schedule is a delay "
+                                                    "(0-255) and a shift (0-7)");
+                break;
+            }
+            level->row_schedules[row].delay = (uint8_t) delay;
+            level->row_schedules[row].shift = (uint8_t) shift;
+            row++;
+        } else if (strcmp(word, "balls") == 0) {
+            unsigned balls = 0;
+            if (sscanf(rest, "%u %1s", &balls, extra) != 1 || balls < 1 || balls > 255) {
+                ok = level_error(path, line_number, "balls is 1-255");
+            }
+            level->num_balls = (uint8_t) balls;
+        } else if (strcmp(word, "speed") == 0) {
+            unsigned speed = 0;
+            if (sscanf(rest, "%u %1s", &speed, extra) != 1 || speed < 1 || speed > 255) {
+                ok = level_error(path, line_number, "speed is 1-255");
+            }
+            level->ball_speed = (uint8_t) speed;
+        } else if (strcmp(word, "fall") == 0) {
+            unsigned clock_size = 0;
+            unsigned acceleration = 0;
+            if (sscanf(rest, "%u %u %1s", &clock_size, &acceleration, extra) != 2 ||
+                clock_size > UINT16_MAX - 1 || acceleration > UINT16_MAX - 1) {
+                ok = level_error(path, line_number, "fall is a clock size and an acceleration, "
+                                                    "in frames");
+            }
+            level->fall_clock_size = (uint16_t) clock_size;
+            level->acceleration = (uint16_t) acceleration;
+        } else if (strcmp(word, "bricks") == 0) {
+            row = 0;
+        } else {
+            ok = level_error(path, line_number, "Unknown setting");
+        }
+    }
+    fclose(in);
+    if (!ok) {
+        return false;
+    }
+    if (row != NUM_BRICK_ROWS) {
+        return level_error(path, line_number, "Expected `bricks` and NUM_BRICK_ROWS rows");
+    }
+    for (int i = 0; i < NUM_BRICKS; i++) {
+        if (level->health[i] > 0) {
+            return true;
+        }
+    }
+    return level_error(path, line_number, "A level needs at least one brick");
+}
+
+int main(int argc, char **argv) {
+    int num_levels = argc - 1;
+    if (num_levels < 1 || num_levels > 256) {
+        fprintf(stderr, "Usage: %s LEVEL_FILE... (1 to 256 of them)\n", argv[0]);
+        return 2;
+    }
+
+    uint32_t offsets[256];
+    Bit_Stream stream;
+    bits_begin(&stream, pack, sizeof(pack));
+    for (int i = 0; i < num_levels; i++) {
+        Level_Source level;
+        if (!parse_level(argv[i + 1], &level)) {
+            return 1;
+        }
+        // Levels start on a byte, for their header
+        stream.bit = bits_size(&stream) * 8;
+        offsets[i] = stream.bit / 8;
+        pack_level(&level, &stream);
+        if (stream.overflowed) {
+            fprintf(stderr, "ERROR: The level pack is bigger than %d bytes\n", MAX_PACK_SIZE);
+            return 1;
+        }
+    }
+    uint32_t size = bits_size(&stream);
+
+    printf("// Generated by native/level_compiler.c, do not edit\n"
+           "#ifndef LEVELS_H_\n"
+           "#define LEVELS_H_\n"
+           "\n"
+           "#include <stdint.h>\n"
+           "\n"
+           "#define NUM_LEVELS      %d\n"
+           "#define LEVEL_PACK_SIZE %u\n"
+           "\n"
+           "// Where each level starts in level_pack\n"
+           "static const uint16_t level_pack_offsets[NUM_LEVELS] = {",
+           num_levels, size);
+    for (int i = 0; i < num_levels; i++) {
+        printf("%s%u,", i % 12 == 0 ? "\n    " : " ", offsets[i]);
+    }
+    printf("\n};\n"
+           "\n"
+           "static const uint8_t level_pack[LEVEL_PACK_SIZE] = {");
+    for (uint32_t i = 0; i < size; i++) {
+        printf("%s0x%02x,", i % 12 == 0 ? "\n    " : " ", pack[i]);
+    }
+    printf("\n};\n"
+           "\n"
+           "#endif\n");
+    return 0;
+}
@@ -0,0 +1,126 @@
+// Memory map of the cart, from `llvm-nm --print-size --radix=d` of an
+// unstripped link on stdin (see `make memory-report`).
+//
+// The cart's linear memory is laid out as:
+//   [0, 0x19a0)           WASM-4 registers and framebuffer
+//   [0x19a0, stack_size)  the stack (--stack-first), growing down
+//   [stack_size, ...)     data, rodata and bss
+//   ... up to memory_size
+// Prints each region and every data symbol (largest first), then
+// exits with 1 if fewer than --min-free bytes are left at the end.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Where the WASM-4 registers and framebuffer end
+#define W4_RESERVED_END 0x19a0
+
+#define MAX_SYMBOLS 1024
+
+typedef struct {
+    unsigned long address;
+    unsigned long size;
+    char nm_type;
+    char name[96];
+} Symbol;
+
+static Symbol symbols[MAX_SYMBOLS];
+
+static int compare_size(const void *a, const void *b) {
+    const Symbol *x = a;
+    const Symbol *y = b;
+    if (x->size != y->size) {
+        return x->size < y->size ? 1 : -1;
+    }
+    return x->address < y->address ? -1 : x->address > y->address;
+}
+
+typedef enum {
+    KIND_DATA,
+    KIND_RODATA,
+    KIND_BSS,
+    NUM_KINDS
+} Symbol_Kind;
+
+static const char *kind_names[NUM_KINDS] = {"data", "rodata", "bss"};
+
+static Symbol_Kind symbol_kind(char nm_type) {
+    switch (nm_type) {
+    case 'b': case 'B': return KIND_BSS;
+    case 'r': case 'R': return KIND_RODATA;
+    default:            return KIND_DATA;
+    }
+}
+
+int main(int argc, char **argv) {
+    unsigned long stack_size = 0;
+    unsigned long memory_size = 0;
+    unsigned long min_free = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--stack-size") == 0 && i + 1 < argc) {
+            stack_size = strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--memory-size") == 0 && i + 1 < argc) {
+            memory_size = strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--min-free") == 0 && i + 1 < argc) {
+            min_free = strtoul(argv[++i], NULL, 0);
+        } else {
+            fprintf(stderr,
+                    "Usage: llvm-nm --print-size --radix=d CART | "
+                    "%s --stack-size N --memory-size N [--min-free N]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+    if (stack_size <= W4_RESERVED_END || memory_size <= stack_size) {
+        fprintf(stderr, "ERROR: Need --stack-size > %d and --memory-size > --stack-size\n",
+                W4_RESERVED_END);
+        return 2;
+    }
+
+    int num_symbols = 0;
+    unsigned long sizes[NUM_KINDS] = {0};
+    unsigned long data_end = stack_size;
+    char line[256];
+    while (fgets(line, sizeof(line), stdin)) {
+        Symbol symbol;
+        // Symbols without a size (functions, imports) have fewer fields
+        if (sscanf(line, "%lu %lu %c %95s", &symbol.address, &symbol.size,
+                   &symbol.nm_type, symbol.name) != 4 ||
+            !strchr("bBdDrR", symbol.nm_type) || symbol.size == 0) {
+            continue;
+        }
+        if (num_symbols == MAX_SYMBOLS) {
+            fprintf(stderr, "ERROR: More than %d data symbols\n", MAX_SYMBOLS);
+            return 1;
+        }
+        symbols[num_symbols++] = symbol;
+        sizes[symbol_kind(symbol.nm_type)] += symbol.size;
+        if (symbol.address + symbol.size > data_end) {
+            data_end = symbol.address + symbol.size;
+        }
+    }
+    qsort(symbols, (size_t) num_symbols, sizeof(symbols[0]), compare_size);
+
+    unsigned long bytes_free = data_end < memory_size ? memory_size - data_end : 0;
+    printf("%-16s %8s %8s %8s\n", "region", "start", "end", "bytes");
+    printf("%-16s %#8x %#8x %8d\n", "wasm4", 0, W4_RESERVED_END, W4_RESERVED_END);
+    printf("%-16s %#8x %#8lx %8lu\n", "stack", W4_RESERVED_END, stack_size,
+           stack_size - W4_RESERVED_END);
+    printf("%-16s %#8lx %#8lx %8lu  (data %lu, rodata %lu, bss %lu)\n", "static",
+           stack_size, data_end, data_end - stack_size,
+           sizes[KIND_DATA], sizes[KIND_RODATA], sizes[KIND_BSS]);
+    printf("%-16s %#8lx %#8lx %8lu\n", "free", data_end, memory_size, bytes_free);
+
+    printf("\n%-8s %8s %-6s %s\n", "address", "bytes", "kind", "symbol");
+    for (int i = 0; i < num_symbols; i++) {
+        printf("%#8lx %8lu %-6s %s\n", symbols[i].address, symbols[i].size,
+               kind_names[symbol_kind(symbols[i].nm_type)], symbols[i].name);
+    }
+
+    if (data_end > memory_size || bytes_free < min_free) {
+        fprintf(stderr, "\nERROR: %lu bytes free, the budget needs at least %lu\n",
+                bytes_free, min_free);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,311 @@
+// Netplay test: two peers play a versus game against each other with
+// rollback (src/rollback.h, netplay_advance() in main.c), the
+// autoplayer playing player 1 on one and player 2 on the other, over a
+// simulated link that delays, reorders and loses their packets.
+//
+// Each peer is a Game_State of its own in this process, stepped only
+// from what it got over the link. A packet has every input of its
+// peer's player the other peer hasn't acknowledged yet, so a lost one
+// is made up for by the next, and the hash of the newest frame whose
+// inputs are all in. Once both peers have played --frames frames and
+// have every input, their states are compared with each other and with
+// a plain run of the same inputs without any rollback.
+//
+// Prints the rollbacks, frames simulated again and time spent per
+// peer, and exits with 1 on a desync.
+#include "main.c"
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define DEFAULT_NETPLAY_FRAMES 36000
+#define MAX_PACKET_INPUTS      ROLLBACK_INPUT_FRAMES
+#define MAX_IN_FLIGHT          256
+// Ticks after --frames for the last inputs to get through
+#define MAX_DRAIN_TICKS        10000
+
+typedef struct {
+    // Inputs of the sender's player from this frame on
+    uint32_t first_frame;
+    uint8_t num_inputs;
+    uint8_t inputs[MAX_PACKET_INPUTS];
+    // Frames of the receiver's player the sender has
+    uint32_t ack;
+    bool has_hash;
+    uint32_t hash_frame;
+    uint32_t hash;
+    // Link tick it's delivered on
+    uint32_t deliver_at;
+} Packet;
+
+// One way of the link
+typedef struct {
+    Packet packets[MAX_IN_FLIGHT];
+    int count;
+    unsigned long sent;
+    unsigned long lost;
+} Link;
+
+typedef struct {
+    uint32_t latency;
+    uint32_t jitter;
+    uint32_t loss_percent;
+    uint32_t random;
+} Link_Settings;
+
+typedef struct {
+    Game_State state;
+    Rollback rollback;
+    int player;
+    // Frames of its player's inputs the other peer has
+    uint32_t acked;
+    // Every input its player pressed, for the plain run
+    uint8_t *log;
+    unsigned long stalls;
+    uint64_t total_ns;
+    uint64_t max_ns;
+} Peer;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+}
+
+static void send_packet(Link *link, Link_Settings *settings, const Packet *packet,
+                        uint32_t tick) {
+    link->sent++;
+    if (random_below(&settings->random, 100) < settings->loss_percent ||
+        link->count == MAX_IN_FLIGHT) {
+        link->lost++;
+        return;
+    }
+    Packet *p = &link->packets[link->count++];
+    *p = *packet;
+    // Jitter reorders packets too
+    p->deliver_at = tick + settings->latency + random_below(&settings->random,
+                                                           settings->jitter + 1);
+}
+
+static void receive_packet(Peer *peer, const Packet *packet) {
+    Rollback *rollback = &peer->rollback;
+    int remote = 1 - peer->player;
+    for (uint32_t i = 0; i < packet->num_inputs; i++) {
+        if (!rollback_add_input(rollback, remote, packet->first_frame + i, packet->inputs[i])) {
+            break;
+        }
+    }
+    if (packet->ack > peer->acked) {
+        peer->acked = packet->ack;
+    }
+    if (packet->has_hash) {
+        rollback_receive_hash(rollback, packet->hash_frame, packet->hash);
+    }
+}
+
+static void deliver_packets(Link *link, Peer *to, uint32_t tick) {
+    for (int i = 0; i < link->count;) {
+        if (link->packets[i].deliver_at <= tick) {
+            receive_packet(to, &link->packets[i]);
+            link->packets[i] = link->packets[--link->count];
+        } else {
+            i++;
+        }
+    }
+}
+
+static Packet make_packet(const Peer *peer) {
+    const Rollback *rollback = &peer->rollback;
+    Packet packet = {.first_frame=peer->acked, .ack=rollback->confirmed[1 - peer->player]};
+    uint32_t end = rollback->confirmed[peer->player];
+    for (uint32_t frame = peer->acked; frame < end && packet.num_inputs < MAX_PACKET_INPUTS;
+         frame++) {
+        packet.inputs[packet.num_inputs++] =
+            rollback->inputs[frame % ROLLBACK_INPUT_FRAMES][peer->player];
+    }
+    packet.has_hash = rollback_final_hash(rollback, &packet.hash_frame, &packet.hash);
+    return packet;
+}
+
+static void start_peer(Peer *peer, int player, uint32_t input_delay, unsigned long num_frames) {
+    memset(&peer->state, 0, sizeof(peer->state));
+    game_reset(&peer->state, FIRST_LEVEL, ICE_CREAM_GB, SINGLE_BALL_MODE, ENDLESS_SEED, ARENA_BRICKS);
+    peer->state.netplay = true;
+    rollback_reset(&peer->rollback);
+    peer->player = player;
+    peer->acked = 0;
+    peer->log = calloc(num_frames + input_delay, 1);
+    if (!peer->log) {
+        fprintf(stderr, "ERROR: Out of memory\n");
+        exit(1);
+    }
+    // Nobody presses anything before the input delay is over
+    for (uint32_t frame = 0; frame < input_delay; frame++) {
+        for (int p = 0; p < ROLLBACK_PLAYERS; p++) {
+            rollback_add_input(&peer->rollback, p, frame, 0);
+        }
+    }
+}
+
+// A tick of a peer: its player presses the buttons for the frame
+// input_delay frames ahead, then it simulates the next frame if it can
+static void tick_peer(Peer *peer, uint32_t input_delay, unsigned long num_frames) {
+    Rollback *rollback = &peer->rollback;
+    uint64_t begin = now_ns();
+    uint32_t input_frame = rollback->frame + input_delay;
+    if (rollback->confirmed[peer->player] == input_frame && input_frame < num_frames &&
+        rollback->frame < rollback_confirmed_frame(rollback) + ROLLBACK_MAX_FRAMES) {
+        uint8_t input = autoplayer_player_input(&peer->state, peer->player);
+        if (rollback_add_input(rollback, peer->player, input_frame, input)) {
+            peer->log[input_frame] = input;
+        }
+    }
+    bool advanced = rollback->frame < num_frames &&
+                    netplay_advance(&peer->state, rollback, peer->player, NULL);
+    if (!advanced) {
+        // Catches up with inputs that came in all the same
+        netplay_resimulate(&peer->state, rollback, NULL);
+        rollback_check_hash(rollback);
+        if (rollback->frame < num_frames) {
+            peer->stalls++;
+        }
+    }
+    uint64_t elapsed = now_ns() - begin;
+    peer->total_ns += elapsed;
+    peer->max_ns = elapsed > peer->max_ns ? elapsed : peer->max_ns;
+}
+
+static bool peer_done(const Peer *peer, unsigned long num_frames) {
+    const Rollback *rollback = &peer->rollback;
+    return rollback->frame == num_frames && rollback_confirmed_frame(rollback) >= num_frames &&
+           rollback->rollback_to == rollback->frame;
+}
+
+// The same inputs, a frame at a time without any rollback
+static uint32_t plain_run(const Peer *peers, unsigned long num_frames) {
+    static Game_State state;
+    memset(&state, 0, sizeof(state));
+    game_reset(&state, FIRST_LEVEL, ICE_CREAM_GB, SINGLE_BALL_MODE, ENDLESS_SEED, ARENA_BRICKS);
+    state.netplay = true;
+    for (unsigned long frame = 0; frame < num_frames; frame++) {
+        game_step(&state, peers[0].log[frame], peers[1].log[frame], NULL);
+    }
+    return game_state_checksum(&state);
+}
+
+static void usage(const char *program) {
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  --frames N       frames of versus to play (default: %d)\n"
+            "  --latency N      link latency, in frames (default: 3)\n"
+            "  --jitter N       extra latency of up to N frames, reorders packets\n"
+            "                   (default: 2)\n"
+            "  --loss N         percentage of packets lost (default: 10)\n"
+            "  --input-delay N  frames between a press and the frame it's for\n"
+            "                   (default: 2)\n"
+            "  --seed N         seed of the link's losses and delays\n"
+            "  --desync-at N    flip an input of player 1 on player 2's peer at\n"
+            "                   frame N, to check the desync is caught\n",
+            program, DEFAULT_NETPLAY_FRAMES);
+}
+
+int main(int argc, char **argv) {
+    unsigned long num_frames = DEFAULT_NETPLAY_FRAMES;
+    Link_Settings settings = {.latency=3, .jitter=2, .loss_percent=10, .random=0x9e3779b9u};
+    uint32_t input_delay = 2;
+    unsigned long desync_at = ULONG_MAX;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (strcmp(arg, "--frames") == 0 && has_value) {
+            num_frames = strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(arg, "--latency") == 0 && has_value) {
+            settings.latency = (uint32_t) strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(arg, "--jitter") == 0 && has_value) {
+            settings.jitter = (uint32_t) strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(arg, "--loss") == 0 && has_value) {
+            settings.loss_percent = (uint32_t) strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(arg, "--input-delay") == 0 && has_value) {
+            input_delay = (uint32_t) strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(arg, "--seed") == 0 && has_value) {
+            // xorshift32 never leaves 0
+            settings.random = (uint32_t) strtoul(argv[++i], NULL, 0) | 1;
+        } else if (strcmp(arg, "--desync-at") == 0 && has_value) {
+            desync_at = strtoul(argv[++i], NULL, 10);
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (num_frames == 0 || num_frames >= UINT32_MAX || settings.loss_percent >= 100 ||
+        input_delay >= ROLLBACK_INPUT_FRAMES - ROLLBACK_MAX_FRAMES - 1) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    static Peer peers[ROLLBACK_PLAYERS];
+    static Link links[ROLLBACK_PLAYERS];
+    for (int p = 0; p < ROLLBACK_PLAYERS; p++) {
+        start_peer(&peers[p], p, input_delay, num_frames);
+    }
+
+    uint32_t tick = 0;
+    for (; tick < num_frames + MAX_DRAIN_TICKS; tick++) {
+        if (peer_done(&peers[0], num_frames) && peer_done(&peers[1], num_frames)) {
+            break;
+        }
+        for (int p = 0; p < ROLLBACK_PLAYERS; p++) {
+            Peer *peer = &peers[p];
+            // links[p] goes to peer p
+            deliver_packets(&links[p], peer, tick);
+            tick_peer(peer, input_delay, num_frames);
+            // As if a packet had been corrupted on the way
+            Rollback *rollback = &peer->rollback;
+            if (p == 1 && rollback->confirmed[0] > desync_at) {
+                rollback->inputs[desync_at % ROLLBACK_INPUT_FRAMES][0] ^= BUTTON_RIGHT;
+                if (desync_at < rollback->rollback_to) {
+                    rollback->rollback_to = (uint32_t) desync_at;
+                }
+                desync_at = ULONG_MAX;
+            }
+            Packet packet = make_packet(peer);
+            send_packet(&links[1 - p], &settings, &packet, tick);
+        }
+    }
+
+    uint32_t checksums[ROLLBACK_PLAYERS];
+    bool failed = false;
+    for (int p = 0; p < ROLLBACK_PLAYERS; p++) {
+        const Peer *peer = &peers[p];
+        const Rollback *rollback = &peer->rollback;
+        checksums[p] = game_state_checksum(&peer->state);
+        printf("peer=%d frames=%u stalls=%lu rollbacks=%u resimulated=%u max_depth=%u "
+               "ns_per_tick=%.1f ns_max=%llu packets_sent=%lu packets_lost=%lu\n",
+               p, rollback->frame, peer->stalls, rollback->rollbacks, rollback->resimulated,
+               rollback->max_depth, tick ? (double) peer->total_ns / (double) tick : 0.0,
+               (unsigned long long) peer->max_ns, links[1 - p].sent, links[1 - p].lost);
+        if (rollback->desync_frame != ROLLBACK_NO_DESYNC) {
+            printf("peer=%d desync at frame %u\n", p, rollback->desync_frame);
+            failed = true;
+        }
+        if (!peer_done(peer, num_frames)) {
+            printf("peer=%d didn't get every input\n", p);
+            failed = true;
+        }
+    }
+    uint32_t plain = plain_run(peers, num_frames);
+    bool same = checksums[0] == checksums[1] && checksums[0] == plain;
+    printf("ticks=%u level=%d bricks_broken=%d,%d checksums=%08x,%08x plain=%08x %s\n",
+           tick, peers[0].state.level, peers[0].state.bricks_broken[0],
+           peers[0].state.bricks_broken[1], checksums[0], checksums[1], plain,
+           same ? "matched" : "diverged");
+
+    for (int p = 0; p < ROLLBACK_PLAYERS; p++) {
+        free(peers[p].log);
+    }
+    return failed || !same ? 1 : 0;
+}
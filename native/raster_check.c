@@ -0,0 +1,204 @@
+// Checks the rasterizer (src/raster.h) against the runtime's rect()
+// and blitSub().
+//
+// Draws random rects (on and partly off screen, every fill/stroke
+// combination) and random blits from the cart's sprites and a random
+// sprite (every alignment, every draw colors) over a framebuffer of
+// random pixels, once with each, and compares the framebuffers pixel
+// for pixel. Exits with 1 on the first difference.
+#include "raster.h"
+#include "sprites.h"
+#include "utils.h"
+#include "w4_runtime.h"
+#include "wasm4.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DEFAULT_CHECK_CASES 100000
+
+#define RANDOM_SPRITE_WIDTH  64
+#define RANDOM_SPRITE_HEIGHT 32
+
+#define FRAMEBUFFER_SIZE (SCREEN_SIZE * SCREEN_SIZE / 4)
+
+static uint32_t rng_state = 0x2545f491;
+
+static uint32_t next_random(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+// In [lo, hi]
+static int random_between(int lo, int hi) {
+    return lo + (int) (next_random() % (uint32_t) (hi - lo + 1));
+}
+
+// A palette color (1-4) or transparent (0) per nibble
+static uint16_t random_draw_colors(void) {
+    uint16_t draw_colors = 0;
+    for (int i = 0; i < 4; i++) {
+        draw_colors |= (uint16_t) (random_between(0, 4) << (i << 2));
+    }
+    return draw_colors;
+}
+
+typedef struct {
+    const uint8_t *pixels;
+    int width;
+    int height;
+} Check_Sprite;
+
+static uint8_t random_sprite[RANDOM_SPRITE_WIDTH * RANDOM_SPRITE_HEIGHT / 4];
+static uint8_t before[FRAMEBUFFER_SIZE];
+static uint8_t expected[FRAMEBUFFER_SIZE];
+
+static void describe_mismatch(const char *what) {
+    for (int i = 0; i < SCREEN_SIZE * SCREEN_SIZE; i++) {
+        int shift = (i & 0x3) << 1;
+        int want = (expected[i >> 2] >> shift) & 0x3;
+        int got = (FRAMEBUFFER[i >> 2] >> shift) & 0x3;
+        if (want != got) {
+            fprintf(stderr, "MISMATCH: %s: pixel (%d, %d) is %d, expected %d\n",
+                    what, i % SCREEN_SIZE, i / SCREEN_SIZE, got, want);
+            return;
+        }
+    }
+}
+
+// Runs draw_host and draw_raster from the same random framebuffer
+// and compares the results
+static bool check_case(const char *what, void (*draw_host)(void *), void (*draw_raster)(void *),
+                       void *args) {
+    for (int i = 0; i < FRAMEBUFFER_SIZE; i++) {
+        before[i] = (uint8_t) next_random();
+    }
+
+    memcpy(FRAMEBUFFER, before, FRAMEBUFFER_SIZE);
+    draw_host(args);
+    memcpy(expected, FRAMEBUFFER, FRAMEBUFFER_SIZE);
+
+    memcpy(FRAMEBUFFER, before, FRAMEBUFFER_SIZE);
+    draw_raster(args);
+    if (memcmp(expected, FRAMEBUFFER, FRAMEBUFFER_SIZE) != 0) {
+        describe_mismatch(what);
+        return false;
+    }
+    return true;
+}
+
+typedef struct {
+    Rect r;
+    uint16_t draw_colors;
+} Rect_Case;
+
+static void host_rect(void *args) {
+    Rect_Case *c = args;
+    *DRAW_COLORS = c->draw_colors;
+    rect(c->r.x, c->r.y, (uint32_t) c->r.width, (uint32_t) c->r.height);
+}
+
+static void raster_rect_case(void *args) {
+    Rect_Case *c = args;
+    raster_rect(c->r, c->draw_colors);
+}
+
+typedef struct {
+    Check_Sprite sprite;
+    Rect r;
+    int src_x;
+    int src_y;
+    uint16_t draw_colors;
+} Blit_Case;
+
+static void host_blit(void *args) {
+    Blit_Case *c = args;
+    *DRAW_COLORS = c->draw_colors;
+    blitSub(c->sprite.pixels, c->r.x, c->r.y, (uint32_t) c->r.width, (uint32_t) c->r.height,
+            (uint32_t) c->src_x, (uint32_t) c->src_y, (uint32_t) c->sprite.width, BLIT_2BPP);
+}
+
+static Raster_Color_Map blit_colors;
+
+static void raster_blit_case(void *args) {
+    Blit_Case *c = args;
+    raster_set_draw_colors(&blit_colors, c->draw_colors);
+    raster_blit(&blit_colors, c->sprite.pixels, c->r, c->src_x, c->src_y,
+                c->sprite.width, BLIT_2BPP);
+}
+
+static Rect random_rect(int max_size) {
+    Rect r;
+    if (random_between(0, 7) == 0) {
+        // Whole rows
+        r.x = 0;
+        r.width = SCREEN_SIZE;
+    } else {
+        r.x = random_between(-max_size, SCREEN_SIZE);
+        r.width = random_between(1, max_size);
+    }
+    r.y = random_between(-max_size, SCREEN_SIZE);
+    r.height = random_between(1, max_size);
+    return r;
+}
+
+int main(int argc, char **argv) {
+    unsigned long num_cases = DEFAULT_CHECK_CASES;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--cases") == 0 && i + 1 < argc) {
+            num_cases = strtoul(argv[++i], NULL, 10);
+        } else {
+            fprintf(stderr,
+                    "Usage: %s [--cases N]\n"
+                    "Compares the rasterizer with the runtime's rect() and blitSub().\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+
+    w4_runtime_init(NULL);
+    w4_runtime_set_trace_enabled(false);
+    for (size_t i = 0; i < sizeof(random_sprite); i++) {
+        random_sprite[i] = (uint8_t) next_random();
+    }
+    const Check_Sprite sprites[] = {
+        {brick_atlas, BRICK_ATLAS_WIDTH, BRICK_ATLAS_HEIGHT},
+        {ball_strip, BALL_STRIP_WIDTH, BALL_STRIP_HEIGHT},
+        {random_sprite, RANDOM_SPRITE_WIDTH, RANDOM_SPRITE_HEIGHT},
+    };
+
+    char what[128];
+    for (unsigned long n = 0; n < num_cases; n++) {
+        if (n & 1) {
+            Rect_Case c = {random_rect(48), random_draw_colors()};
+            snprintf(what, sizeof(what), "rect(%d, %d, %d, %d) with 0x%04x",
+                     c.r.x, c.r.y, c.r.width, c.r.height, c.draw_colors);
+            if (!check_case(what, host_rect, raster_rect_case, &c)) {
+                return 1;
+            }
+        } else {
+            Blit_Case c;
+            c.sprite = sprites[next_random() % ARRAY_LEN(sprites)];
+            c.src_x = random_between(0, c.sprite.width - 1);
+            c.src_y = random_between(0, c.sprite.height - 1);
+            c.r.width = random_between(1, c.sprite.width - c.src_x);
+            c.r.height = random_between(1, c.sprite.height - c.src_y);
+            c.r.x = random_between(-c.r.width, SCREEN_SIZE);
+            c.r.y = random_between(-c.r.height, SCREEN_SIZE);
+            c.draw_colors = random_draw_colors();
+            snprintf(what, sizeof(what),
+                     "blitSub(%dx%d sprite, %d, %d, %d, %d, %d, %d) with 0x%04x",
+                     c.sprite.width, c.sprite.height, c.r.x, c.r.y, c.r.width, c.r.height,
+                     c.src_x, c.src_y, c.draw_colors);
+            if (!check_case(what, host_blit, raster_blit_case, &c)) {
+                return 1;
+            }
+        }
+    }
+
+    printf("%lu cases, rasterizer matches rect() and blitSub()\n", num_cases);
+    return 0;
+}
@@ -0,0 +1,68 @@
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef REPLAY_FILE_H_
+#define REPLAY_FILE_H_
+
+// Replays as files, for the native tools (which include main.c before
+// this, for Disk_Image).
+
+bool replay_save(const Replay_Header *header, const char *path) {
+    FILE *out = fopen(path, "wb");
+    if (!out) {
+        return false;
+    }
+    size_t size = sizeof(Replay_Header) + header->num_runs * sizeof(Replay_Run);
+    bool written = fwrite(header, 1, size, out) == size;
+    return fclose(out) == 0 && written;
+}
+
+// Loads a replay of any length (the runs follow the header), also
+// takes disks written by the cart (see Disk_Image).
+// Returns NULL (and prints why) on error.
+Replay_Header *replay_load(const char *path) {
+    FILE *in = fopen(path, "rb");
+    if (!in) {
+        fprintf(stderr, "ERROR: Could not open %s\n", path);
+        return NULL;
+    }
+    size_t size = 0;
+    size_t capacity = 0;
+    uint8_t *data = NULL;
+    for (;;) {
+        if (size == capacity) {
+            capacity = capacity ? capacity * 2 : 4096;
+            uint8_t *grown = realloc(data, capacity);
+            if (!grown) {
+                free(data);
+                fclose(in);
+                fprintf(stderr, "ERROR: Out of memory\n");
+                return NULL;
+            }
+            data = grown;
+        }
+        size_t read = fread(data + size, 1, capacity - size, in);
+        if (read == 0) {
+            break;
+        }
+        size += read;
+    }
+    fclose(in);
+
+    Replay_Header *header = (Replay_Header *) data;
+    if (size <= UINT32_MAX && !replay_valid(header, (uint32_t) size) &&
+        size >= offsetof(Disk_Image, replay)) {
+        memmove(data, data + offsetof(Disk_Image, replay), size - offsetof(Disk_Image, replay));
+        size -= offsetof(Disk_Image, replay);
+    }
+    if (size > UINT32_MAX || !replay_valid(header, (uint32_t) size)) {
+        fprintf(stderr, "ERROR: %s is not a valid replay\n", path);
+        free(data);
+        return NULL;
+    }
+    return header;
+}
+
+#endif
@@ -0,0 +1,291 @@
+// Soak test: the autoplayer (see autoplayer_input()) plays every level
+// of the level pack and a few generated ones, in both game modes, in
+// turn until the frames run out, and the game's invariants are checked
+// after every frame. Half way through each level it pauses the game,
+// presses every switch of the help screen and checks the game is still
+// the same and saves and loads whole before going back to it.
+//
+// Prints one CSV row per level and game mode: frames played, clears,
+// lost games, level attempts that ran out of frames, ns/frame mean and
+// max. A crash (a panic aborts on the native host) prints the frame
+// and level it happened on. Exits with an error on a crash or a broken
+// invariant.
+#include "main.c"
+
+#include "w4_runtime.h"
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define DEFAULT_SOAK_FRAMES       1000000
+// Frames a level gets before the soak test moves on to the next one
+#define DEFAULT_LEVEL_FRAMES      30000
+#define DEFAULT_GENERATED_LEVELS  8
+
+typedef struct {
+    Level level;
+    Game_Mode game_mode;
+    unsigned long frames;
+    unsigned long clears;
+    unsigned long losses;
+    unsigned long timeouts;
+    uint64_t total_ns;
+    uint64_t max_ns;
+} Soak_Level;
+
+// Where the soak test is, for the crash handler
+static volatile unsigned long current_frame;
+static volatile const Soak_Level *current_level;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+}
+
+static void on_crash(int signal_number) {
+    char message[160];
+    const Soak_Level *level = (const Soak_Level *) current_level;
+    int length = snprintf(message, sizeof(message),
+                          "CRASH: signal %d at frame %lu, level %d, %s mode, seed 0x%08x%s\n",
+                          signal_number, current_frame, level ? level->level : -1,
+                          level && level->game_mode == MULTI_BALL_MODE ? "multi-ball" : "single ball",
+                          endless_seed,
+                          signal_number == SIGABRT ? " (panics abort, see --trace)" : "");
+    if (length > 0) {
+        ssize_t written = write(STDERR_FILENO, message, (size_t) length);
+        (void) written;
+    }
+    _exit(3);
+}
+
+// What must hold after every frame, returns what doesn't or NULL
+static const char *check_invariants(void) {
+    if (state.screen_kind >= NUM_SCREEN) {
+        return "screen_kind out of range";
+    }
+    if (state.paddle_x < MIN_PADDLE_X || state.paddle_x > MAX_PADDLE_X) {
+        return "paddle_x out of range";
+    }
+    const Ball_Pool *balls = &state.balls;
+    if (balls->count > MAX_BALLS) {
+        return "more balls than MAX_BALLS";
+    }
+    if (state.screen_kind == GAME_SCREEN && balls->count == 0) {
+        return "no ball on GAME_SCREEN";
+    }
+    for (int i = 0; i < balls->count; i++) {
+        if (balls->x[i] < 0 || balls->x[i] > int_to_fixed(SCREEN_SIZE - BALL_DIAMETER) ||
+            balls->y[i] < 0 || balls->y[i] >= int_to_fixed(SCREEN_SIZE)) {
+            return "a ball left the play field";
+        }
+    }
+    const Brick_Field *bricks = &state.bricks;
+    int num_alive = 0;
+    for (int i = 0; i < NUM_BRICKS; i++) {
+        bool alive = (bricks->alive_rows[i / NUM_BRICK_COLS] >> (i % NUM_BRICK_COLS)) & 1;
+        if (alive != (brick_health(bricks, i) > 0)) {
+            return "alive_rows doesn't match the brick health";
+        }
+        num_alive += alive;
+    }
+    if (num_alive != bricks->num_alive) {
+        return "num_alive doesn't match the bricks";
+    }
+    return NULL;
+}
+
+static void enter_level(const Soak_Level *level) {
+    state.level = level->level;
+    state.game_mode = level->game_mode;
+    state.endless = true;
+    reset_level(&state);
+    state.screen_kind = GAME_SCREEN;
+    state.in_progress = true;
+    state.previous_gamepad = 0;
+    renderer.events.full_repaint = true;
+}
+
+// Pauses the game, presses every switch of the help screen on both
+// gamepads (ball mode, endless mode, versus, arena) and goes back to
+// the game. Those are for a new game, so the paused one must come back
+// the same, and it must still load from its save state. Returns what
+// broke or NULL.
+static const char *check_paused_switches(void) {
+    static const uint8_t presses[][NUM_PLAYERS] = {
+        {BUTTON_DOWN, 0}, {0, 0}, {BUTTON_2, 0}, {0, 0}, {BUTTON_RIGHT, 0}, {0, 0},
+        {0, BUTTON_2}, {0, 0}, {BUTTON_DOWN, 0}, {BUTTON_DOWN | BUTTON_UP, 0}, {0, 0},
+    };
+    static Game_State before;
+    before = state;
+    for (size_t i = 0; i < ARRAY_LEN(presses); i++) {
+        w4_runtime_set_gamepad(0, presses[i][0]);
+        w4_runtime_set_gamepad(1, presses[i][1]);
+        w4_runtime_begin_frame();
+        update();
+    }
+    w4_runtime_set_gamepad(1, 0);
+    if (state.screen_kind != HELP_SCREEN || !state.in_progress) {
+        return "the paused game isn't paused";
+    }
+    if (state.level != before.level || state.game_mode != before.game_mode ||
+        state.endless != before.endless || state.versus != before.versus ||
+        state.arena != before.arena || state.balls.count != before.balls.count ||
+        state.bricks.num_alive != before.bricks.num_alive) {
+        return "a help screen switch changed the paused game";
+    }
+    if (game_fits_save_state(&state)) {
+        static uint8_t save_state[SAVE_STATE_DISK_SIZE];
+        static Game_State loaded;
+        if (!save_game_state(&state, save_state) || !load_game_state(&loaded, save_state)) {
+            return "the paused game doesn't save and load";
+        }
+    }
+    w4_runtime_set_gamepad(0, BUTTON_UP);
+    w4_runtime_begin_frame();
+    update();
+    return NULL;
+}
+
+static void usage(const char *program) {
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  --frames N        frames to play in total (default: %d)\n"
+            "  --level-frames N  frames a level gets before moving on (default: %d)\n"
+            "  --generated N     generated levels played after the level pack\n"
+            "                    (default: %d)\n"
+            "  --seed N          seed of the generated levels\n"
+            "  --trace           show trace()/tracef() (e.g; panic messages)\n"
+            "Prints one CSV row per level and game mode on stdout.\n",
+            program, DEFAULT_SOAK_FRAMES, DEFAULT_LEVEL_FRAMES, DEFAULT_GENERATED_LEVELS);
+}
+
+int main(int argc, char **argv) {
+    unsigned long num_frames = DEFAULT_SOAK_FRAMES;
+    unsigned long level_frames = DEFAULT_LEVEL_FRAMES;
+    unsigned long num_generated = DEFAULT_GENERATED_LEVELS;
+    bool trace_on = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (strcmp(arg, "--frames") == 0 && has_value) {
+            num_frames = strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(arg, "--level-frames") == 0 && has_value) {
+            level_frames = strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(arg, "--generated") == 0 && has_value) {
+            num_generated = strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(arg, "--seed") == 0 && has_value) {
+            endless_seed = (uint32_t) strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(arg, "--trace") == 0) {
+            trace_on = true;
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (level_frames == 0 || num_generated > LAST_LEVEL - NUM_LEVELS) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    size_t num_levels = (NUM_LEVELS + num_generated) * NUM_GAME_MODES;
+    Soak_Level *levels = calloc(num_levels, sizeof(*levels));
+    if (!levels) {
+        fprintf(stderr, "ERROR: Out of memory\n");
+        return 1;
+    }
+    for (size_t i = 0; i < num_levels; i++) {
+        levels[i].level = (Level) (i / NUM_GAME_MODES);
+        levels[i].game_mode = (Game_Mode) (i % NUM_GAME_MODES);
+    }
+
+    int signals[] = {SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT};
+    for (size_t i = 0; i < ARRAY_LEN(signals); i++) {
+        signal(signals[i], on_crash);
+    }
+
+    w4_runtime_init(NULL);
+    w4_runtime_set_trace_enabled(trace_on);
+    start();
+    attract.enabled = false;
+
+    unsigned long failures = 0;
+    size_t next = 0;
+    Soak_Level *level = NULL;
+    unsigned long level_frame = 0;
+    bool cleared = false;
+    for (unsigned long frame = 0; frame < num_frames; frame++) {
+        // Cleared levels go on once the game over screen is done
+        if (!level || level_frame == level_frames ||
+            (cleared && state.screen_kind != GAME_OVER_SCREEN)) {
+            if (level && !cleared) {
+                level->timeouts++;
+            }
+            level = &levels[next];
+            next = (next + 1) % num_levels;
+            level_frame = 0;
+            cleared = false;
+            enter_level(level);
+            current_level = level;
+        }
+        current_frame = frame;
+
+        if (level_frame == level_frames / 2 && state.screen_kind == GAME_SCREEN) {
+            const char *broken = check_paused_switches();
+            if (broken) {
+                fprintf(stderr, "ERROR: Frame %lu, level %d: %s\n", frame, level->level, broken);
+                failures++;
+            }
+        }
+        Screen_Kind screen_kind = state.screen_kind;
+        w4_runtime_set_gamepad(0, autoplayer_input(&state));
+        uint64_t begin = now_ns();
+        w4_runtime_begin_frame();
+        update();
+        uint64_t elapsed = now_ns() - begin;
+
+        level->frames++;
+        level->total_ns += elapsed;
+        level->max_ns = elapsed > level->max_ns ? elapsed : level->max_ns;
+        level_frame++;
+        if (screen_kind == GAME_SCREEN && state.screen_kind == GAME_OVER_SCREEN) {
+            if (any_brick_alive(&state)) {
+                level->losses++;
+            } else {
+                level->clears++;
+                cleared = true;
+            }
+        }
+
+        const char *broken = check_invariants();
+        if (broken) {
+            fprintf(stderr, "ERROR: Frame %lu, level %d: %s\n", frame, level->level, broken);
+            failures++;
+            // A level at a time, the next one starts clean
+            level_frame = level_frames;
+        }
+    }
+
+    printf("level,mode,frames,clears,losses,timeouts,ns_mean,ns_max\n");
+    for (size_t i = 0; i < num_levels; i++) {
+        const Soak_Level *l = &levels[i];
+        if (l->frames == 0) {
+            continue;
+        }
+        printf("%d,%s,%lu,%lu,%lu,%lu,%.1f,%llu\n",
+               l->level, l->game_mode == MULTI_BALL_MODE ? "multi" : "single",
+               l->frames, l->clears, l->losses, l->timeouts,
+               (double) l->total_ns / (double) l->frames, (unsigned long long) l->max_ns);
+    }
+    free(levels);
+    if (failures > 0) {
+        fprintf(stderr, "ERROR: %lu broken invariants\n", failures);
+        return 1;
+    }
+    return 0;
+}
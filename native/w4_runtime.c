@@ -0,0 +1,390 @@
+// Software WASM-4 runtime for native builds.
+// Framebuffer semantics follow the reference runtime:
+// https://github.com/aduros/wasm4/blob/main/runtimes/native/src/framebuffer.c
+
+#include "w4_runtime.h"
+#include "wasm4.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+_Alignas(16) uint8_t w4_memory[W4_MEMORY_SIZE];
+
+static const char *disk_path = NULL;
+static uint8_t disk_data[W4_DISK_SIZE];
+static uint32_t disk_size = 0;
+static bool trace_enabled = true;
+static W4_Host_Stats stats = {0};
+
+static int min_int(int a, int b) {
+    return a < b ? a : b;
+}
+
+static int max_int(int a, int b) {
+    return a > b ? a : b;
+}
+
+void w4_runtime_init(const char *path) {
+    memset(w4_memory, 0, sizeof(w4_memory));
+    PALETTE[0] = 0xe0f8cf;
+    PALETTE[1] = 0x86c06c;
+    PALETTE[2] = 0x306850;
+    PALETTE[3] = 0x071821;
+    *DRAW_COLORS = 0x1203;
+
+    memset(&stats, 0, sizeof(stats));
+    disk_path = path;
+    disk_size = 0;
+    if (disk_path) {
+        FILE *file = fopen(disk_path, "rb");
+        if (file) {
+            disk_size = (uint32_t) fread(disk_data, 1, W4_DISK_SIZE, file);
+            fclose(file);
+        }
+    }
+}
+
+void w4_runtime_set_gamepad(int player, uint8_t buttons) {
+    w4_memory[0x16 + (player & 0x3)] = buttons;
+}
+
+void w4_runtime_begin_frame(void) {
+    if (!(*SYSTEM_FLAGS & SYSTEM_PRESERVE_FRAMEBUFFER)) {
+        memset(FRAMEBUFFER, 0, SCREEN_SIZE * SCREEN_SIZE / 4);
+    }
+}
+
+void w4_runtime_set_trace_enabled(bool enabled) {
+    trace_enabled = enabled;
+}
+
+W4_Host_Stats w4_runtime_take_stats(void) {
+    W4_Host_Stats result = stats;
+    memset(&stats, 0, sizeof(stats));
+    return result;
+}
+
+void w4_note_framebuffer_write(uint32_t bytes) {
+    stats.framebuffer_bytes += bytes;
+}
+
+bool w4_runtime_save_screenshot(const char *path) {
+    FILE *file = fopen(path, "wb");
+    if (!file) {
+        return false;
+    }
+    fprintf(file, "P6\n%d %d\n255\n", SCREEN_SIZE, SCREEN_SIZE);
+    for (int i = 0; i < SCREEN_SIZE * SCREEN_SIZE; i++) {
+        uint8_t color = (FRAMEBUFFER[i >> 2] >> ((i & 0x3) << 1)) & 0x3;
+        uint32_t rgb = PALETTE[color];
+        uint8_t pixel[3] = {
+            (uint8_t) (rgb >> 16), (uint8_t) (rgb >> 8), (uint8_t) rgb
+        };
+        fwrite(pixel, 1, sizeof(pixel), file);
+    }
+    return fclose(file) == 0;
+}
+
+// ┌───────────────────────────────────────────────────────────────────────────┐
+// │ Framebuffer                                                               │
+// └───────────────────────────────────────────────────────────────────────────┘
+
+static void draw_point(uint8_t color, int x, int y) {
+    int idx = (SCREEN_SIZE * y + x) >> 2;
+    int shift = (x & 0x3) << 1;
+    int mask = 0x3 << shift;
+    FRAMEBUFFER[idx] = (uint8_t) ((color << shift) | (FRAMEBUFFER[idx] & ~mask));
+    stats.framebuffer_bytes++;
+}
+
+static void draw_point_clipped(uint8_t color, int x, int y) {
+    if (x >= 0 && x < SCREEN_SIZE && y >= 0 && y < SCREEN_SIZE) {
+        draw_point(color, x, y);
+    }
+}
+
+// Draws [start_x, end_x) on row y, both already clipped
+static void draw_hline_fast(uint8_t color, int start_x, int y, int end_x) {
+    int fill_end = end_x - (end_x & 0x3);
+    int fill_start = min_int((start_x + 3) & ~0x3, fill_end);
+
+    if (fill_end - fill_start > 3) {
+        for (int xx = start_x; xx < fill_start; xx++) {
+            draw_point(color, xx, y);
+        }
+        int from = (SCREEN_SIZE * y + fill_start) >> 2;
+        int to = (SCREEN_SIZE * y + fill_end) >> 2;
+        memset(FRAMEBUFFER + from, color * 0x55, (size_t) (to - from));
+        stats.framebuffer_bytes += (uint32_t) (to - from);
+        start_x = fill_end;
+    }
+
+    for (int xx = start_x; xx < end_x; xx++) {
+        draw_point(color, xx, y);
+    }
+}
+
+static void draw_blit(const uint8_t *sprite, int dst_x, int dst_y, int width, int height,
+                      int src_x, int src_y, int src_stride, uint32_t flags) {
+    uint16_t colors = *DRAW_COLORS;
+    bool bpp2 = flags & BLIT_2BPP;
+    bool flip_x = flags & BLIT_FLIP_X;
+    bool flip_y = flags & BLIT_FLIP_Y;
+    bool rotate = flags & BLIT_ROTATE;
+
+    int clip_x_min, clip_y_min, clip_x_max, clip_y_max;
+    if (rotate) {
+        flip_x = !flip_x;
+        clip_x_min = max_int(0, dst_y) - dst_y;
+        clip_y_min = max_int(0, dst_x) - dst_x;
+        clip_x_max = min_int(width, SCREEN_SIZE - dst_y);
+        clip_y_max = min_int(height, SCREEN_SIZE - dst_x);
+    } else {
+        clip_x_min = max_int(0, dst_x) - dst_x;
+        clip_y_min = max_int(0, dst_y) - dst_y;
+        clip_x_max = min_int(width, SCREEN_SIZE - dst_x);
+        clip_y_max = min_int(height, SCREEN_SIZE - dst_y);
+    }
+
+    for (int y = clip_y_min; y < clip_y_max; y++) {
+        for (int x = clip_x_min; x < clip_x_max; x++) {
+            int tx = dst_x + (rotate ? y : x);
+            int ty = dst_y + (rotate ? x : y);
+            int sx = src_x + (flip_x ? width - x - 1 : x);
+            int sy = src_y + (flip_y ? height - y - 1 : y);
+            int bit_index = sy * src_stride + sx;
+
+            uint8_t color_index;
+            if (bpp2) {
+                uint8_t byte = sprite[bit_index >> 2];
+                int shift = 6 - ((bit_index & 0x3) << 1);
+                color_index = (byte >> shift) & 0x3;
+            } else {
+                uint8_t byte = sprite[bit_index >> 3];
+                int shift = 7 - (bit_index & 0x7);
+                color_index = (byte >> shift) & 0x1;
+            }
+
+            uint8_t dc = (colors >> (color_index << 2)) & 0xf;
+            if (dc != 0) {
+                draw_point((dc - 1) & 0x3, tx, ty);
+            }
+        }
+    }
+}
+
+// ┌───────────────────────────────────────────────────────────────────────────┐
+// │ Drawing Functions                                                         │
+// └───────────────────────────────────────────────────────────────────────────┘
+
+void blit(const uint8_t *data, int32_t x, int32_t y, uint32_t width, uint32_t height,
+          uint32_t flags) {
+    stats.blit++;
+    draw_blit(data, x, y, (int) width, (int) height, 0, 0, (int) width, flags);
+}
+
+void blitSub(const uint8_t *data, int32_t x, int32_t y, uint32_t width, uint32_t height,
+             uint32_t src_x, uint32_t src_y, uint32_t stride, uint32_t flags) {
+    stats.blit++;
+    draw_blit(data, x, y, (int) width, (int) height,
+              (int) src_x, (int) src_y, (int) stride, flags);
+}
+
+void line(int32_t x1, int32_t y1, int32_t x2, int32_t y2) {
+    stats.line++;
+    uint8_t dc0 = *DRAW_COLORS & 0xf;
+    if (dc0 == 0) {
+        return;
+    }
+    uint8_t color = (dc0 - 1) & 0x3;
+
+    int dx = x2 > x1 ? x2 - x1 : x1 - x2;
+    int dy = y2 > y1 ? y1 - y2 : y2 - y1;
+    int sx = x1 < x2 ? 1 : -1;
+    int sy = y1 < y2 ? 1 : -1;
+    int err = dx + dy;
+    for (;;) {
+        draw_point_clipped(color, x1, y1);
+        if (x1 == x2 && y1 == y2) {
+            break;
+        }
+        int e2 = err * 2;
+        if (e2 >= dy) {
+            err += dy;
+            x1 += sx;
+        }
+        if (e2 <= dx) {
+            err += dx;
+            y1 += sy;
+        }
+    }
+}
+
+void hline(int32_t x, int32_t y, uint32_t len) {
+    stats.hline++;
+    uint8_t dc0 = *DRAW_COLORS & 0xf;
+    if (dc0 == 0 || y < 0 || y >= SCREEN_SIZE) {
+        return;
+    }
+    int start_x = max_int(0, x);
+    int end_x = min_int(SCREEN_SIZE, x + (int) len);
+    if (start_x < end_x) {
+        draw_hline_fast((dc0 - 1) & 0x3, start_x, y, end_x);
+    }
+}
+
+void vline(int32_t x, int32_t y, uint32_t len) {
+    stats.vline++;
+    uint8_t dc0 = *DRAW_COLORS & 0xf;
+    if (dc0 == 0 || x < 0 || x >= SCREEN_SIZE) {
+        return;
+    }
+    int start_y = max_int(0, y);
+    int end_y = min_int(SCREEN_SIZE, y + (int) len);
+    for (int yy = start_y; yy < end_y; yy++) {
+        draw_point((dc0 - 1) & 0x3, x, yy);
+    }
+}
+
+void rect(int32_t x, int32_t y, uint32_t width, uint32_t height) {
+    stats.rect++;
+    int start_x = max_int(0, x);
+    int start_y = max_int(0, y);
+    int end_x_unclamped = x + (int) width;
+    int end_y_unclamped = y + (int) height;
+    int end_x = min_int(end_x_unclamped, SCREEN_SIZE);
+    int end_y = min_int(end_y_unclamped, SCREEN_SIZE);
+
+    uint8_t dc0 = *DRAW_COLORS & 0xf;
+    uint8_t dc1 = (*DRAW_COLORS >> 4) & 0xf;
+
+    if (dc0 != 0) {
+        uint8_t fill = (dc0 - 1) & 0x3;
+        for (int yy = start_y; yy < end_y; yy++) {
+            draw_hline_fast(fill, start_x, yy, end_x);
+        }
+    }
+
+    if (dc1 != 0) {
+        uint8_t stroke = (dc1 - 1) & 0x3;
+
+        // Left edge
+        if (x >= 0 && x < SCREEN_SIZE) {
+            for (int yy = start_y; yy < end_y; yy++) {
+                draw_point(stroke, x, yy);
+            }
+        }
+        // Right edge
+        if (end_x_unclamped > 0 && end_x_unclamped <= SCREEN_SIZE) {
+            for (int yy = start_y; yy < end_y; yy++) {
+                draw_point(stroke, end_x_unclamped - 1, yy);
+            }
+        }
+        // Top edge
+        if (y >= 0 && y < SCREEN_SIZE && start_x < end_x) {
+            draw_hline_fast(stroke, start_x, y, end_x);
+        }
+        // Bottom edge
+        if (end_y_unclamped > 0 && end_y_unclamped <= SCREEN_SIZE && start_x < end_x) {
+            draw_hline_fast(stroke, start_x, end_y_unclamped - 1, end_x);
+        }
+    }
+}
+
+// The WASM-4 system font is not bundled with the native runtime. Glyphs
+// are a deterministic stand-in derived from the character code: text
+// covers the same 8x8 cells and costs the same as on the console, but
+// does not look like the real font.
+static uint8_t glyph_row(char c, int row) {
+    if (c == ' ' || row == 0 || row == 7) {
+        return 0;
+    }
+    uint32_t bits = (uint32_t) (unsigned char) c * 0x9e3779b1u;
+    return (uint8_t) (((bits >> (row * 4)) & 0x3c) | 0x42);
+}
+
+void text(const char *str, int32_t x, int32_t y) {
+    stats.text++;
+    uint16_t colors = *DRAW_COLORS;
+    uint8_t fg = colors & 0xf;
+    uint8_t bg = (colors >> 4) & 0xf;
+    int cursor_x = x;
+
+    for (; *str; str++) {
+        if (*str == '\n') {
+            y += FONT_SIZE;
+            cursor_x = x;
+            continue;
+        }
+        for (int row = 0; row < FONT_SIZE; row++) {
+            uint8_t bits = glyph_row(*str, row);
+            for (int col = 0; col < FONT_SIZE; col++) {
+                uint8_t dc = (bits & (0x80 >> col)) ? fg : bg;
+                if (dc != 0) {
+                    draw_point_clipped((dc - 1) & 0x3, cursor_x + col, y + row);
+                }
+            }
+        }
+        cursor_x += FONT_SIZE;
+    }
+}
+
+// ┌───────────────────────────────────────────────────────────────────────────┐
+// │ Sound Functions                                                           │
+// └───────────────────────────────────────────────────────────────────────────┘
+
+void tone(uint32_t frequency, uint32_t duration, uint32_t volume, uint32_t flags) {
+    stats.tone++;
+    (void) frequency;
+    (void) duration;
+    (void) volume;
+    (void) flags;
+}
+
+// ┌───────────────────────────────────────────────────────────────────────────┐
+// │ Storage Functions                                                         │
+// └───────────────────────────────────────────────────────────────────────────┘
+
+uint32_t diskr(void *dest, uint32_t size) {
+    stats.diskr++;
+    if (size > disk_size) {
+        size = disk_size;
+    }
+    memcpy(dest, disk_data, size);
+    return size;
+}
+
+uint32_t diskw(const void *src, uint32_t size) {
+    stats.diskw++;
+    if (size > W4_DISK_SIZE) {
+        size = W4_DISK_SIZE;
+    }
+    memcpy(disk_data, src, size);
+    disk_size = size;
+    if (disk_path) {
+        FILE *file = fopen(disk_path, "wb");
+        if (file) {
+            fwrite(disk_data, 1, disk_size, file);
+            fclose(file);
+        }
+    }
+    return size;
+}
+
+void trace(const char *str) {
+    if (trace_enabled) {
+        fprintf(stderr, "%s\n", str);
+    }
+}
+
+void tracef(const char *fmt, ...) {
+    if (!trace_enabled) {
+        return;
+    }
+    va_list args;
+    va_start(args, fmt);
+    vfprintf(stderr, fmt, args);
+    va_end(args);
+    fputc('\n', stderr);
+}
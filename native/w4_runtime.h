@@ -0,0 +1,50 @@
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifndef W4_RUNTIME_H_
+#define W4_RUNTIME_H_
+
+// Software WASM-4 runtime for native (headless) builds of the cart.
+// Provides the memory map, a 160x160 2bpp framebuffer and software
+// versions of the drawing / sound / storage imports declared in wasm4.h.
+
+#define W4_MEMORY_SIZE 65536
+#define W4_DISK_SIZE   1024
+
+// Host call counts and framebuffer bytes written since the last
+// w4_runtime_take_stats()
+typedef struct {
+    uint32_t rect;
+    uint32_t hline;
+    uint32_t vline;
+    uint32_t line;
+    uint32_t text;
+    uint32_t blit;
+    uint32_t tone;
+    uint32_t diskr;
+    uint32_t diskw;
+    uint32_t framebuffer_bytes;
+} W4_Host_Stats;
+
+// Resets memory to the WASM-4 power-on state and loads the disk
+// contents from disk_path (if given and present). diskw() writes
+// back to the same file.
+void w4_runtime_init(const char *disk_path);
+
+// Sets the state of GAMEPAD1 - GAMEPAD4 (player is 0 based)
+void w4_runtime_set_gamepad(int player, uint8_t buttons);
+
+// Must be called before each update(), clears the framebuffer
+// unless SYSTEM_PRESERVE_FRAMEBUFFER is set
+void w4_runtime_begin_frame(void);
+
+// Enables or disables trace()/tracef() output (on stderr)
+void w4_runtime_set_trace_enabled(bool enabled);
+
+// Returns the stats accumulated so far and resets them
+W4_Host_Stats w4_runtime_take_stats(void);
+
+// Writes the framebuffer as a binary PPM using the current PALETTE
+bool w4_runtime_save_screenshot(const char *path);
+
+#endif
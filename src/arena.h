@@ -0,0 +1,196 @@
+#include "balls.h"
+#include "bricks.h"
+#include "perf_counters.h"
+#include "utils.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifndef ARENA_H_
+#define ARENA_H_
+
+// Arena: a brick field many screens tall that the view scrolls over.
+// Its bottom rows are where a level's are and the rest go up from
+// there, into negative y, so the paddle and everything below the
+// bricks stays where it is in a level. Bricks don't fall in an arena.
+//
+// Same grid and same half a byte of health per brick as Brick_Field,
+// with any number of rows up to ARENA_MAX_ROWS. Rows are also grouped
+// into bands with a count of the bricks left in each, a coarse index
+// over the grid: stretches of the arena that were cleared are skipped
+// a band at a time, and the lowest bricks are found without looking at
+// every row.
+
+// The cart only plays arenas of ARENA_BRICKS (see src/main.c), the room
+// for bigger ones is only worth it on the native host
+#ifdef W4_NATIVE
+#define ARENA_MAX_BRICKS 10000
+#else
+#define ARENA_MAX_BRICKS 2400
+#endif
+#define ARENA_MAX_ROWS   ((ARENA_MAX_BRICKS + NUM_BRICK_COLS - 1) / NUM_BRICK_COLS)
+#define ARENA_BAND_ROWS  8
+#define ARENA_MAX_BANDS  ((ARENA_MAX_ROWS + ARENA_BAND_ROWS - 1) / ARENA_BAND_ROWS)
+
+_Static_assert(ARENA_BAND_ROWS * NUM_BRICK_COLS <= UINT8_MAX, "Bands are too big to count");
+
+typedef struct {
+    uint16_t num_rows;
+    uint16_t num_bricks;
+    uint16_t num_alive;
+    // Two bricks per byte, even indices in the low nibble. A brick is
+    // identified by its grid index (row * NUM_BRICK_COLS + col), row 0
+    // being the top one.
+    uint8_t health[(ARENA_MAX_ROWS * NUM_BRICK_COLS + 1) / 2];
+    Brick_Row_Mask alive_rows[ARENA_MAX_ROWS];
+    // Alive bricks in each band of ARENA_BAND_ROWS rows
+    uint8_t band_alive[ARENA_MAX_BANDS];
+} Brick_Arena;
+
+uint8_t arena_brick_health(const Brick_Arena *arena, int i) {
+    return (arena->health[i >> 1] >> ((i & 1) << 2)) & 0xf;
+}
+
+void set_arena_brick_health(Brick_Arena *arena, int i, uint8_t health) {
+    int shift = (i & 1) << 2;
+    arena->health[i >> 1] = (uint8_t) (
+        (arena->health[i >> 1] & ~(0xf << shift)) | ((health & 0xf) << shift));
+}
+
+int arena_row_y(const Brick_Arena *arena, int row) {
+    return BRICK_PAD + BRICK_INITIAL_Y + (row + NUM_BRICK_ROWS - arena->num_rows) *
+                                         BRICK_HEIGHT_PLUS_PADDING;
+}
+
+// Top of the play field: 0 in a level, higher up (less) by how much
+// taller the arena is
+int arena_top(const Brick_Arena *arena) {
+    int top = arena_row_y(arena, 0) - BRICK_PAD - BRICK_INITIAL_Y;
+    return top < 0 ? top : 0;
+}
+
+Rect arena_brick_rect(const Brick_Arena *arena, int i) {
+    Rect r = {
+        .x=brick_col_x(i % NUM_BRICK_COLS),
+        .y=arena_row_y(arena, i / NUM_BRICK_COLS),
+        .width=BRICK_WIDTH,
+        .height=BRICK_HEIGHT,
+    };
+    return r;
+}
+
+// Rows with bricks that overlap or touch [y, y + height), returns false
+// if there are none
+bool arena_rows_between(const Brick_Arena *arena, int y, int height, int *first, int *last) {
+    int grid_top = arena_row_y(arena, 0);
+    *first = floor_div(y - grid_top - (BRICK_HEIGHT), BRICK_HEIGHT_PLUS_PADDING);
+    *last = floor_div(y + height - grid_top, BRICK_HEIGHT_PLUS_PADDING);
+    if (*first < 0) *first = 0;
+    if (*last > arena->num_rows - 1) *last = arena->num_rows - 1;
+    return *first <= *last;
+}
+
+// An arena of num_bricks (up to ARENA_MAX_BRICKS) from a seed, the
+// bricks getting tougher the further up they are. The top row is the
+// one left short if they don't fill the rows.
+void generate_arena(Brick_Arena *arena, int num_bricks, uint32_t seed) {
+    int num_rows = (num_bricks + NUM_BRICK_COLS - 1) / NUM_BRICK_COLS;
+    arena->num_rows = (uint16_t) num_rows;
+    arena->num_bricks = (uint16_t) num_bricks;
+    arena->num_alive = (uint16_t) num_bricks;
+    memset(arena->health, 0, sizeof(arena->health));
+    memset(arena->alive_rows, 0, sizeof(arena->alive_rows));
+    memset(arena->band_alive, 0, sizeof(arena->band_alive));
+
+    uint32_t random = seed | 1;
+    int first = num_rows * NUM_BRICK_COLS - num_bricks;
+    for (int i = first; i < num_rows * NUM_BRICK_COLS; i++) {
+        int row = i / NUM_BRICK_COLS;
+        // Another point of health every two screens up
+        uint32_t most = (uint32_t) (num_rows - 1 - row) / 40 + 2;
+        uint32_t health = 1 + random_below(&random, most < MAX_BRICK_HEALTH ? most : MAX_BRICK_HEALTH);
+        set_arena_brick_health(arena, i, (uint8_t) health);
+        arena->alive_rows[row] |= (Brick_Row_Mask) (1 << (i % NUM_BRICK_COLS));
+        arena->band_alive[row / ARENA_BAND_ROWS]++;
+    }
+}
+
+// Takes one health point from a brick, returns true if that killed it
+bool damage_arena_brick(Brick_Arena *arena, int i) {
+    uint8_t health = (uint8_t) (arena_brick_health(arena, i) - 1);
+    set_arena_brick_health(arena, i, health);
+    if (health > 0) {
+        return false;
+    }
+    int row = i / NUM_BRICK_COLS;
+    arena->alive_rows[row] &= (Brick_Row_Mask) ~(1 << (i % NUM_BRICK_COLS));
+    arena->band_alive[row / ARENA_BAND_ROWS]--;
+    arena->num_alive--;
+    return true;
+}
+
+// The lowest row with a brick left, or -1 once there are none
+int arena_lowest_row(const Brick_Arena *arena) {
+    for (int band = (arena->num_rows - 1) / ARENA_BAND_ROWS; band >= 0; band--) {
+        if (arena->band_alive[band] == 0) {
+            continue;
+        }
+        int row = band * ARENA_BAND_ROWS + ARENA_BAND_ROWS - 1;
+        if (row > arena->num_rows - 1) {
+            row = arena->num_rows - 1;
+        }
+        while (arena->alive_rows[row] == 0) {
+            row--;
+        }
+        return row;
+    }
+    return -1;
+}
+
+// Same as sweep_bricks() in main.c: the rows and columns the area the
+// ball sweeps maps to are all that is looked at, minus the bands that
+// are empty, so it costs the same however big the arena is
+int sweep_arena(const Brick_Arena *arena, Fixed x, Fixed y, Fixed dx, Fixed dy, Sweep_Hit *hit) {
+    Rect swept = {
+        .x=fixed_floor(dx < 0 ? x + dx : x),
+        .y=fixed_floor(dy < 0 ? y + dy : y),
+    };
+    swept.width = fixed_ceil(dx < 0 ? x : x + dx) + BALL_DIAMETER - swept.x;
+    swept.height = fixed_ceil(dy < 0 ? y : y + dy) + BALL_DIAMETER - swept.y;
+
+    int first_row, last_row;
+    if (!arena_rows_between(arena, swept.y, swept.height, &first_row, &last_row)) {
+        return -1;
+    }
+    int grid_left = BRICK_PAD + BRICK_INITIAL_X;
+    int first_col = floor_div(swept.x - grid_left - (BRICK_WIDTH), BRICK_WIDTH_PLUS_PADDING);
+    int last_col = floor_div(swept.x + swept.width - grid_left, BRICK_WIDTH_PLUS_PADDING);
+    if (first_col < 0) first_col = 0;
+    if (last_col > NUM_BRICK_COLS - 1) last_col = NUM_BRICK_COLS - 1;
+    if (first_col > last_col) {
+        return -1;
+    }
+    Brick_Row_Mask cols = (Brick_Row_Mask) (((1 << (last_col + 1)) - 1) & ~((1 << first_col) - 1));
+
+    int found = -1;
+    Sweep_Hit candidate;
+    for (int row = first_row; row <= last_row; row++) {
+        if (arena->band_alive[row / ARENA_BAND_ROWS] == 0) {
+            row |= ARENA_BAND_ROWS - 1;
+            continue;
+        }
+        for (Brick_Row_Mask mask = arena->alive_rows[row] & cols; mask; mask &= mask - 1) {
+            int i = row * NUM_BRICK_COLS + __builtin_ctz(mask);
+            PERF_COUNT(PERF_BRICK_TESTS);
+            if (sweep_ball_rect(x, y, dx, dy, arena_brick_rect(arena, i), &candidate) &&
+                (found < 0 || candidate.time < hit->time)) {
+                *hit = candidate;
+                found = i;
+            }
+        }
+    }
+    return found;
+}
+
+#endif
@@ -0,0 +1,212 @@
+#include "utils.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifndef BALLS_H_
+#define BALLS_H_
+
+#define BALL_DIAMETER      4
+#define MAX_BALLS          1024
+
+// Top left of the lives HUD, a ball per life left
+#define LIVES_X            1
+#define LIVES_Y            1
+
+// Fixed-capacity pool of balls in structure-of-arrays form, so the
+// per-frame passes over all balls only touch the fields they need.
+// The active balls are always [0, count); removing a ball moves the
+// last one into its slot.
+typedef struct {
+    // Top left corner, in sub-pixels
+    Fixed x[MAX_BALLS];
+    Fixed y[MAX_BALLS];
+    // Sub-pixels per frame
+    int16_t velocity_x[MAX_BALLS];
+    int16_t velocity_y[MAX_BALLS];
+    uint16_t count;
+} Ball_Pool;
+
+// The pixels a ball covers
+Rect ball_rect(const Ball_Pool *balls, int i) {
+    Rect r = {
+        .x=fixed_floor(balls->x[i]),
+        .y=fixed_floor(balls->y[i]),
+        .width=BALL_DIAMETER,
+        .height=BALL_DIAMETER,
+    };
+    return r;
+}
+
+// Adds a ball at a pixel position, returns its index or -1 if the
+// pool is full
+int spawn_ball(Ball_Pool *balls, int x, int y, Fixed velocity_x, Fixed velocity_y) {
+    if (balls->count == MAX_BALLS) {
+        return -1;
+    }
+    int i = balls->count++;
+    balls->x[i] = int_to_fixed(x);
+    balls->y[i] = int_to_fixed(y);
+    balls->velocity_x[i] = (int16_t) velocity_x;
+    balls->velocity_y[i] = (int16_t) velocity_y;
+    return i;
+}
+
+void remove_ball(Ball_Pool *balls, int i) {
+    int last = --balls->count;
+    balls->x[i] = balls->x[last];
+    balls->y[i] = balls->y[last];
+    balls->velocity_x[i] = balls->velocity_x[last];
+    balls->velocity_y[i] = balls->velocity_y[last];
+}
+
+// The ball sitting on the paddle waiting to be launched
+bool ball_resting(const Ball_Pool *balls) {
+    return balls->count == 1 && balls->velocity_y[0] == 0;
+}
+
+// Frames until ball i's top gets down to y at its current velocity,
+// bouncing off the top at 0 and off the side walls (its left edge
+// stays in [0, max_x]); *x is where its left edge is by then. Bricks
+// and the paddle are left out, so it's only a guess while bricks are
+// in the way. Returns -1 for a ball that isn't moving.
+int32_t predict_ball_landing(const Ball_Pool *balls, int i, int y, int max_x, Fixed *x) {
+    int32_t speed_y = balls->velocity_y[i];
+    if (speed_y == 0) {
+        return -1;
+    }
+    Fixed target = int_to_fixed(y);
+    // Up to the top and back down
+    Fixed distance = speed_y > 0 ? target - balls->y[i] : balls->y[i] + target;
+    if (speed_y < 0) {
+        speed_y = -speed_y;
+    }
+    int32_t frames = distance > 0 ? (distance + speed_y - 1) / speed_y : 0;
+
+    // The side walls fold the straight path back into [0, span]
+    int64_t span = int_to_fixed(max_x);
+    int64_t folded = (balls->x[i] + (int64_t) balls->velocity_x[i] * frames) % (2 * span);
+    if (folded < 0) {
+        folded += 2 * span;
+    }
+    *x = (Fixed) (folded > span ? 2 * span - folded : folded);
+    return frames;
+}
+
+// Where a ball sweeping through a frame first touches a rect
+typedef struct {
+    // Fraction of the sweep travelled, FIXED_ONE is all of it
+    Fixed time;
+    // Ball position at that point
+    Fixed x;
+    Fixed y;
+    // Which way the ball has to go on each axis to get away from the
+    // rect: -1, 1 or 0 if it didn't hit a face on that axis
+    int8_t normal_x;
+    int8_t normal_y;
+} Sweep_Hit;
+
+// Times at which a point moving by d along an axis is inside (lo, hi).
+// Returns false if it never is.
+bool sweep_axis(Fixed p, Fixed d, Fixed lo, Fixed hi, Fixed *entry, Fixed *exit) {
+    if (d == 0) {
+        if (p <= lo || p >= hi) {
+            return false;
+        }
+        *entry = INT32_MIN;
+        *exit = INT32_MAX;
+        return true;
+    }
+    Fixed near = d > 0 ? lo : hi;
+    Fixed far  = d > 0 ? hi : lo;
+    *entry = fixed_div(near - p, d);
+    *exit  = fixed_div(far - p, d);
+    return true;
+}
+
+// Swept AABB test of a ball moving by (dx, dy) against target.
+// Touching a face doesn't count as a hit, so a ball resting against
+// something, moving away from it or sliding along it is left alone.
+// A ball that starts out overlapping target (e.g. a row of bricks fell
+// onto it) hits at time 0 and is pushed out through the nearest face.
+bool sweep_ball_rect(Fixed x, Fixed y, Fixed dx, Fixed dy, Rect target, Sweep_Hit *hit) {
+    PERF_COUNT(PERF_SWEEP_TESTS);
+    // Minkowski sum of target and the ball, so the ball is a point
+    Fixed left   = int_to_fixed(target.x - BALL_DIAMETER);
+    Fixed right  = int_to_fixed(target.x + target.width);
+    Fixed top    = int_to_fixed(target.y - BALL_DIAMETER);
+    Fixed bottom = int_to_fixed(target.y + target.height);
+
+    hit->x = x;
+    hit->y = y;
+    hit->normal_x = 0;
+    hit->normal_y = 0;
+
+    if (x > left && x < right && y > top && y < bottom) {
+        Fixed depth = x - left;
+        hit->x = left;
+        hit->normal_x = -1;
+        if (right - x < depth) {
+            depth = right - x;
+            hit->x = right;
+            hit->normal_x = 1;
+        }
+        if (y - top < depth) {
+            depth = y - top;
+            hit->x = x;
+            hit->y = top;
+            hit->normal_x = 0;
+            hit->normal_y = -1;
+        }
+        if (bottom - y < depth) {
+            hit->x = x;
+            hit->y = bottom;
+            hit->normal_x = 0;
+            hit->normal_y = 1;
+        }
+        hit->time = 0;
+        return true;
+    }
+
+    Fixed entry_x, exit_x, entry_y, exit_y;
+    if (!sweep_axis(x, dx, left, right, &entry_x, &exit_x) ||
+        !sweep_axis(y, dy, top, bottom, &entry_y, &exit_y)) {
+        return false;
+    }
+    // Not overlapping at the start, so unless the ball is moving away
+    // (exit <= 0) the entry is in the future
+    Fixed entry = entry_x > entry_y ? entry_x : entry_y;
+    Fixed exit  = exit_x < exit_y ? exit_x : exit_y;
+    if (exit <= 0 || entry >= exit || entry > FIXED_ONE) {
+        return false;
+    }
+
+    hit->time = entry;
+    if (entry == entry_x) {
+        hit->x = dx > 0 ? left : right;
+        hit->normal_x = dx > 0 ? -1 : 1;
+    } else {
+        hit->x = x + fixed_mul(dx, entry);
+    }
+    if (entry == entry_y) {
+        hit->y = dy > 0 ? top : bottom;
+        hit->normal_y = dy > 0 ? -1 : 1;
+    } else {
+        hit->y = y + fixed_mul(dy, entry);
+    }
+    return true;
+}
+
+// Sends a ball away from what it hit along the axes in hit
+void reflect_ball(Ball_Pool *balls, int i, const Sweep_Hit *hit) {
+    if (hit->normal_x != 0) {
+        int speed = balls->velocity_x[i] < 0 ? -balls->velocity_x[i] : balls->velocity_x[i];
+        balls->velocity_x[i] = (int16_t) (speed * hit->normal_x);
+    }
+    if (hit->normal_y != 0) {
+        int speed = balls->velocity_y[i] < 0 ? -balls->velocity_y[i] : balls->velocity_y[i];
+        balls->velocity_y[i] = (int16_t) (speed * hit->normal_y);
+    }
+}
+
+#endif
@@ -0,0 +1,97 @@
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifndef BIT_STREAM_H_
+#define BIT_STREAM_H_
+
+// Bits are packed LSB first, a field may straddle bytes
+typedef struct {
+    uint8_t *data;
+    uint32_t capacity;
+    uint32_t bit;
+    // Set when a write or read went past capacity bytes
+    bool overflowed;
+} Bit_Stream;
+
+void bits_begin(Bit_Stream *stream, uint8_t *data, uint32_t capacity) {
+    stream->data = data;
+    stream->capacity = capacity;
+    stream->bit = 0;
+    stream->overflowed = false;
+}
+
+// For data that is only ever read from (bits_read() doesn't write)
+void bits_begin_read(Bit_Stream *stream, const uint8_t *data, uint32_t capacity) {
+    bits_begin(stream, (uint8_t *) data, capacity);
+}
+
+void bits_write(Bit_Stream *stream, uint32_t value, int num_bits) {
+    if (stream->bit + (uint32_t) num_bits > stream->capacity * 8) {
+        stream->overflowed = true;
+        return;
+    }
+    for (int i = 0; i < num_bits; i++, stream->bit++) {
+        uint8_t mask = (uint8_t) (1 << (stream->bit & 0x7));
+        if ((value >> i) & 1) {
+            stream->data[stream->bit >> 3] |= mask;
+        } else {
+            stream->data[stream->bit >> 3] &= (uint8_t) ~mask;
+        }
+    }
+}
+
+uint32_t bits_read(Bit_Stream *stream, int num_bits) {
+    if (stream->bit + (uint32_t) num_bits > stream->capacity * 8) {
+        stream->overflowed = true;
+        return 0;
+    }
+    uint32_t value = 0;
+    for (int i = 0; i < num_bits; i++, stream->bit++) {
+        value |= (uint32_t) ((stream->data[stream->bit >> 3] >> (stream->bit & 0x7)) & 1) << i;
+    }
+    return value;
+}
+
+// Two's complement in num_bits bits
+void bits_write_signed(Bit_Stream *stream, int32_t value, int num_bits) {
+    bits_write(stream, (uint32_t) value & ((1u << num_bits) - 1), num_bits);
+}
+
+int32_t bits_read_signed(Bit_Stream *stream, int num_bits) {
+    uint32_t value = bits_read(stream, num_bits);
+    uint32_t sign = 1u << (num_bits - 1);
+    return (int32_t) (value ^ sign) - (int32_t) sign;
+}
+
+uint32_t bits_size(const Bit_Stream *stream) {
+    return (stream->bit + 7) >> 3;
+}
+
+// Elias gamma code of a value >= 1: as many zeros as it has bits after
+// the leading one, then all of its bits from the top. Small values
+// take few bits (1 is a single bit) with no upper bound.
+void bits_write_gamma(Bit_Stream *stream, uint32_t value) {
+    int top = 31 - __builtin_clz(value);
+    bits_write(stream, 0, top);
+    for (int i = top; i >= 0; i--) {
+        bits_write(stream, (value >> i) & 1, 1);
+    }
+}
+
+uint32_t bits_read_gamma(Bit_Stream *stream) {
+    int top = 0;
+    while (!stream->overflowed && bits_read(stream, 1) == 0) {
+        top++;
+    }
+    if (top > 31) {
+        stream->overflowed = true;
+        return 0;
+    }
+    uint32_t value = 1;
+    for (int i = 0; i < top; i++) {
+        value = (value << 1) | bits_read(stream, 1);
+    }
+    return value;
+}
+
+#endif
@@ -0,0 +1,240 @@
+#include "utils.h"
+#include "wasm4.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifndef BRICKS_H_
+#define BRICKS_H_
+
+#define BRICK_INITIAL_X             2
+#define BRICK_INITIAL_Y             6  // Below the lives HUD
+#define BRICK_PAD                   1
+#define BRICK_WIDTH_PLUS_PADDING    26
+#define BRICK_HEIGHT_PLUS_PADDING   8
+#define BRICK_WIDTH                 (BRICK_WIDTH_PLUS_PADDING)  - (BRICK_PAD * 2)
+#define BRICK_HEIGHT                (BRICK_HEIGHT_PLUS_PADDING) - (BRICK_PAD * 2)
+#define NUM_BRICK_COLS              ((int) ((SCREEN_SIZE - (BRICK_INITIAL_X * 2)) / BRICK_WIDTH_PLUS_PADDING))
+#define NUM_BRICK_ROWS              8
+#define NUM_BRICKS                  (NUM_BRICK_COLS) * (NUM_BRICK_ROWS)
+#define MAX_BRICK_HEALTH            15
+#define MIN_FALL_CLOCK_SIZE         30
+
+// One bit per column, bit c is set while the brick in column c is alive
+typedef uint8_t Brick_Row_Mask;
+_Static_assert(NUM_BRICK_COLS <= 8, "Brick_Row_Mask is too small for NUM_BRICK_COLS");
+
+// When a row falls relative to the level-wide fall clock: it waits
+// `delay` cycles, then moves down a pixel every 2^shift cycles
+typedef struct {
+    uint8_t delay;
+    uint8_t shift;
+} Row_Fall_Schedule;
+
+// One clock for the whole level instead of one per brick. Every
+// clock_size frames a cycle completes; `cycles` is the global fall
+// offset the rows' schedules are applied to. With a non zero
+// acceleration the clock gets that many frames shorter every cycle
+// (down to MIN_FALL_CLOCK_SIZE).
+typedef struct {
+    Clock clock;
+    uint16_t cycles;
+    uint16_t acceleration;
+} Fall_Scheduler;
+
+// Structure-of-arrays brick storage.
+// A brick is identified by its grid index (row * NUM_BRICK_COLS + col).
+// Its position is derived from that index and how far its row has
+// fallen (computed from the fall scheduler on demand), so the only
+// per-brick data is a 4 bit health: a brick costs half a byte plus
+// its share of the per-row state.
+typedef struct {
+    // Two bricks per byte, even indices in the low nibble
+    uint8_t health[(NUM_BRICKS + 1) / 2];
+    Brick_Row_Mask alive_rows[NUM_BRICK_ROWS];
+
+    Fall_Scheduler fall;
+    Row_Fall_Schedule row_schedules[NUM_BRICK_ROWS];
+
+    // Derived from the above, only updated when a brick dies or a
+    // row falls so the queries on them are O(1)
+    uint16_t num_alive;
+    int lowest_bottom;
+    // Least and most any row has fallen, bounds the rows a point
+    // can be in for the collision broadphase
+    int min_row_fall;
+    int max_row_fall;
+} Brick_Field;
+
+uint8_t brick_health(const Brick_Field *bricks, int i) {
+    return (bricks->health[i >> 1] >> ((i & 1) << 2)) & 0xf;
+}
+
+void set_brick_health(Brick_Field *bricks, int i, uint8_t health) {
+    int shift = (i & 1) << 2;
+    bricks->health[i >> 1] = (uint8_t) (
+        (bricks->health[i >> 1] & ~(0xf << shift)) | ((health & 0xf) << shift));
+}
+
+bool brick_alive(const Brick_Field *bricks, int i) {
+    return bricks->alive_rows[i / NUM_BRICK_COLS] & (1 << (i % NUM_BRICK_COLS));
+}
+
+int brick_col_x(int col) {
+    return BRICK_PAD + BRICK_INITIAL_X + col * BRICK_WIDTH_PLUS_PADDING;
+}
+
+// Pixels a row has fallen after the given number of scheduler cycles
+int row_fall_after(Row_Fall_Schedule schedule, int cycles) {
+    if (cycles <= schedule.delay) {
+        return 0;
+    }
+    return (cycles - schedule.delay) >> schedule.shift;
+}
+
+int brick_row_y(const Brick_Field *bricks, int row) {
+    return BRICK_PAD + BRICK_INITIAL_Y + row * BRICK_HEIGHT_PLUS_PADDING +
+           row_fall_after(bricks->row_schedules[row], bricks->fall.cycles);
+}
+
+Rect brick_rect(const Brick_Field *bricks, int i) {
+    Rect r = {
+        .x=brick_col_x(i % NUM_BRICK_COLS),
+        .y=brick_row_y(bricks, i / NUM_BRICK_COLS),
+        .width=BRICK_WIDTH,
+        .height=BRICK_HEIGHT,
+    };
+    return r;
+}
+
+// Bounding box of the alive bricks in a row (empty if there are none)
+Rect brick_row_rect(const Brick_Field *bricks, int row) {
+    Brick_Row_Mask mask = bricks->alive_rows[row];
+    if (mask == 0) {
+        Rect empty = {0};
+        return empty;
+    }
+    int first = __builtin_ctz(mask);
+    int last = 31 - __builtin_clz(mask);
+    Rect r = {
+        .x=brick_col_x(first),
+        .y=brick_row_y(bricks, row),
+        .width=brick_col_x(last) - brick_col_x(first) + BRICK_WIDTH,
+        .height=BRICK_HEIGHT,
+    };
+    return r;
+}
+
+// Bottom edge of the lowest alive brick. Rows can fall at different
+// rates, so every row that still has a brick is looked at; this only
+// runs when a row empties or the fall scheduler completes a cycle.
+void update_lowest_brick_bottom(Brick_Field *bricks) {
+    bricks->lowest_bottom = 0;
+    for (int row = 0; row < NUM_BRICK_ROWS; row++) {
+        if (bricks->alive_rows[row] == 0) {
+            continue;
+        }
+        int bottom = brick_row_y(bricks, row) + BRICK_HEIGHT;
+        if (bottom > bricks->lowest_bottom) {
+            bricks->lowest_bottom = bottom;
+        }
+    }
+}
+
+void update_row_fall_range(Brick_Field *bricks) {
+    bricks->min_row_fall = row_fall_after(bricks->row_schedules[0], bricks->fall.cycles);
+    bricks->max_row_fall = bricks->min_row_fall;
+    for (int row = 1; row < NUM_BRICK_ROWS; row++) {
+        int fall = row_fall_after(bricks->row_schedules[row], bricks->fall.cycles);
+        if (fall < bricks->min_row_fall) bricks->min_row_fall = fall;
+        if (fall > bricks->max_row_fall) bricks->max_row_fall = fall;
+    }
+}
+
+// No bricks, every row falling a pixel per fall clock cycle and
+// nothing fallen yet. Bricks are then added with place_brick() and
+// finish_brick_field() is called once they all are.
+void clear_brick_field(Brick_Field *bricks, uint16_t fall_clock_size, uint16_t acceleration) {
+    memset(bricks->health, 0, sizeof(bricks->health));
+    for (int row = 0; row < NUM_BRICK_ROWS; row++) {
+        bricks->alive_rows[row] = 0;
+        bricks->row_schedules[row].delay = 0;
+        bricks->row_schedules[row].shift = 0;
+    }
+    bricks->fall.clock.clock_size = fall_clock_size;
+    clock_reset(&bricks->fall.clock);
+    bricks->fall.cycles = 0;
+    bricks->fall.acceleration = acceleration;
+    bricks->num_alive = 0;
+}
+
+// Puts a brick with a health of 1 to MAX_BRICK_HEALTH where there is none
+void place_brick(Brick_Field *bricks, int i, uint8_t health) {
+    set_brick_health(bricks, i, health);
+    bricks->alive_rows[i / NUM_BRICK_COLS] |= (Brick_Row_Mask) (1 << (i % NUM_BRICK_COLS));
+    bricks->num_alive++;
+}
+
+// Updates what is derived from the bricks and the row schedules
+void finish_brick_field(Brick_Field *bricks) {
+    update_lowest_brick_bottom(bricks);
+    update_row_fall_range(bricks);
+}
+
+void set_brick_row_schedule(Brick_Field *bricks, int row, uint8_t delay, uint8_t shift) {
+    bricks->row_schedules[row].delay = delay;
+    bricks->row_schedules[row].shift = shift;
+    update_lowest_brick_bottom(bricks);
+    update_row_fall_range(bricks);
+}
+
+void kill_brick(Brick_Field *bricks, int i) {
+    int row = i / NUM_BRICK_COLS;
+    bricks->alive_rows[row] &= (Brick_Row_Mask) ~(1 << (i % NUM_BRICK_COLS));
+    bricks->num_alive--;
+    if (bricks->alive_rows[row] == 0 &&
+        brick_row_y(bricks, row) + BRICK_HEIGHT == bricks->lowest_bottom) {
+        update_lowest_brick_bottom(bricks);
+    }
+}
+
+// Takes one health point from a brick, returns true if that killed it
+bool damage_brick(Brick_Field *bricks, int i) {
+    uint8_t health = (uint8_t) (brick_health(bricks, i) - 1);
+    set_brick_health(bricks, i, health);
+    if (health == 0) {
+        kill_brick(bricks, i);
+        return true;
+    }
+    return false;
+}
+
+// Advances the level-wide fall clock by a frame, returns true if a
+// cycle completed (see brick_row_moved() for which rows fell)
+bool tick_brick_fall(Brick_Field *bricks) {
+    Fall_Scheduler *fall = &bricks->fall;
+    bool cycle = fall->clock.clock == 0 && fall->clock.cycled;
+    if (cycle) {
+        fall->cycles++;
+        if (fall->acceleration > 0) {
+            int size = fall->clock.clock_size - fall->acceleration;
+            fall->clock.clock_size = (uint16_t) (
+                size < MIN_FALL_CLOCK_SIZE ? MIN_FALL_CLOCK_SIZE : size);
+        }
+        update_lowest_brick_bottom(bricks);
+        update_row_fall_range(bricks);
+    }
+    clock_tick(&fall->clock);
+    return cycle;
+}
+
+// Checks if a row moved down during the last completed cycle
+bool brick_row_moved(const Brick_Field *bricks, int row) {
+    int cycles = bricks->fall.cycles;
+    return cycles > 0 &&
+           row_fall_after(bricks->row_schedules[row], cycles) !=
+           row_fall_after(bricks->row_schedules[row], cycles - 1);
+}
+
+#endif
@@ -0,0 +1,58 @@
+#include "utils.h"
+
+#include <stdbool.h>
+
+#ifndef DIRTY_RECTS_H_
+#define DIRTY_RECTS_H_
+
+// Screen regions that need to be repainted this frame.
+// Rects that overlap (or nearly touch) are merged as they are added,
+// once more than MAX_DIRTY_RECTS are needed the whole screen is
+// considered dirty instead.
+
+#define MAX_DIRTY_RECTS  16
+#define DIRTY_MERGE_GAP  2
+
+typedef struct {
+    Rect rects[MAX_DIRTY_RECTS];
+    uint8_t count;
+    bool overflowed;
+} Dirty_Rects;
+
+void dirty_clear(Dirty_Rects *dirty) {
+    dirty->count = 0;
+    dirty->overflowed = false;
+}
+
+void dirty_add(Dirty_Rects *dirty, Rect r) {
+    r = rect_intersection(r, (Rect) {0, 0, SCREEN_SIZE, SCREEN_SIZE});
+    if (dirty->overflowed || rect_empty(r)) {
+        return;
+    }
+
+    // Keep merging until r doesn't come close to any of the stored rects
+    uint8_t i = 0;
+    while (i < dirty->count) {
+        Rect grown = {
+            .x=dirty->rects[i].x - DIRTY_MERGE_GAP,
+            .y=dirty->rects[i].y - DIRTY_MERGE_GAP,
+            .width=dirty->rects[i].width + 2 * DIRTY_MERGE_GAP,
+            .height=dirty->rects[i].height + 2 * DIRTY_MERGE_GAP,
+        };
+        if (rect_empty(rect_intersection(grown, r))) {
+            i++;
+            continue;
+        }
+        r = rect_union(r, dirty->rects[i]);
+        dirty->rects[i] = dirty->rects[--dirty->count];
+        i = 0;
+    }
+
+    if (dirty->count == MAX_DIRTY_RECTS) {
+        dirty->overflowed = true;
+        return;
+    }
+    dirty->rects[dirty->count++] = r;
+}
+
+#endif
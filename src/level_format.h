@@ -0,0 +1,105 @@
+#include "bit_stream.h"
+#include "bricks.h"
+#include "utils.h"
+
+#include <stdint.h>
+
+#ifndef LEVEL_FORMAT_H_
+#define LEVEL_FORMAT_H_
+
+// A packed level is LEVEL_HEADER_SIZE bytes (lives, ball speed) and
+// then bits, packed with bit_stream.h: the fall clock size + 1 and
+// acceleration + 1 gamma coded, a bit telling if any row has a fall
+// schedule and if so each row's delay + 1 (gamma) and shift (3 bits),
+// then runs of bricks in grid order as 4 bits of health (0 is no
+// brick) and the length of the run (gamma).
+//
+// Levels are packed by native/level_compiler.c (into the level pack)
+// and by the level generator (see level_generator.h).
+
+#define LEVEL_HEADER_SIZE 2
+
+// The most a level can take: the largest fall settings and schedules
+// and a run per brick
+#define LEVEL_MAX_PACKED (LEVEL_HEADER_SIZE + \
+    (2 * 33 + 1 + NUM_BRICK_ROWS * (17 + 3) + NUM_BRICKS * (4 + 1) + 7) / 8)
+
+// A level before it's packed
+typedef struct {
+    uint8_t num_balls;
+    // In quarter pixels per frame
+    uint8_t ball_speed;
+    uint16_t fall_clock_size;
+    uint16_t acceleration;
+    uint8_t health[NUM_BRICKS];
+    Row_Fall_Schedule row_schedules[NUM_BRICK_ROWS];
+} Level_Source;
+
+// Packs a level at the (byte aligned) end of stream
+void pack_level(const Level_Source *level, Bit_Stream *stream) {
+    bits_write(stream, level->num_balls, 8);
+    bits_write(stream, level->ball_speed, 8);
+    bits_write_gamma(stream, level->fall_clock_size + 1u);
+    bits_write_gamma(stream, level->acceleration + 1u);
+
+    bool scheduled = false;
+    for (int row = 0; row < NUM_BRICK_ROWS; row++) {
+        scheduled |= level->row_schedules[row].delay != 0 || level->row_schedules[row].shift != 0;
+    }
+    bits_write(stream, scheduled, 1);
+    if (scheduled) {
+        for (int row = 0; row < NUM_BRICK_ROWS; row++) {
+            bits_write_gamma(stream, level->row_schedules[row].delay + 1u);
+            bits_write(stream, level->row_schedules[row].shift, 3);
+        }
+    }
+
+    for (int i = 0; i < NUM_BRICKS;) {
+        int length = 1;
+        while (i + length < NUM_BRICKS && level->health[i + length] == level->health[i]) {
+            length++;
+        }
+        bits_write(stream, level->health[i], 4);
+        bits_write_gamma(stream, (uint32_t) length);
+        i += length;
+    }
+}
+
+uint8_t packed_level_num_balls(const uint8_t *level) {
+    return level[0];
+}
+
+// In sub-pixels per frame
+Fixed packed_level_ball_speed(const uint8_t *level) {
+    return level[1] * (FIXED_ONE / 4);
+}
+
+// Sets up the bricks of a level from its size packed bytes
+void unpack_level_bricks(const uint8_t *level, uint32_t size, Brick_Field *bricks) {
+    Bit_Stream stream;
+    bits_begin_read(&stream, level + LEVEL_HEADER_SIZE, size - LEVEL_HEADER_SIZE);
+
+    uint16_t fall_clock_size = (uint16_t) (bits_read_gamma(&stream) - 1);
+    uint16_t acceleration = (uint16_t) (bits_read_gamma(&stream) - 1);
+    clear_brick_field(bricks, fall_clock_size, acceleration);
+
+    if (bits_read(&stream, 1)) {
+        for (int row = 0; row < NUM_BRICK_ROWS; row++) {
+            bricks->row_schedules[row].delay = (uint8_t) (bits_read_gamma(&stream) - 1);
+            bricks->row_schedules[row].shift = (uint8_t) bits_read(&stream, 3);
+        }
+    }
+
+    for (int i = 0; i < NUM_BRICKS && !stream.overflowed;) {
+        uint8_t health = (uint8_t) bits_read(&stream, 4);
+        uint32_t length = bits_read_gamma(&stream);
+        for (; length > 0 && i < NUM_BRICKS; length--, i++) {
+            if (health > 0) {
+                place_brick(bricks, i, health);
+            }
+        }
+    }
+    finish_brick_field(bricks);
+}
+
+#endif
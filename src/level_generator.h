@@ -0,0 +1,190 @@
+#include "bit_stream.h"
+#include "bricks.h"
+#include "level_format.h"
+#include "utils.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifndef LEVEL_GENERATOR_H_
+#define LEVEL_GENERATOR_H_
+
+// Makes up levels from a seed and a depth (how many generated levels
+// came before). Everything is integer math on the seeded xorshift32 of
+// utils.h, so a seed and depth give the same level on every build.
+//
+// A level takes LEVEL_GENERATOR_STEPS calls to generator_step(), each
+// of them only a little work, so it can be spread over the frames of
+// a screen that has nothing else to do. The result is packed the same
+// way as the levels of the level pack.
+
+typedef enum {
+    PATTERN_SOLID,
+    PATTERN_CHECKER,
+    // Narrow at the top, wider to the bottom
+    PATTERN_PYRAMID,
+    PATTERN_SCATTER,
+    NUM_PATTERNS
+} Level_Pattern;
+
+// Lower rows never fall less than the ones above them, so rows can't
+// fall into each other
+typedef enum {
+    FALL_TOGETHER,
+    // Each row waits a few more cycles than the one below it
+    FALL_BOTTOM_FIRST,
+    // The top half falls at half the speed
+    FALL_TOP_SLOWER,
+    NUM_FALL_STYLES
+} Fall_Style;
+
+// Settings, a step per row, packing
+#define LEVEL_GENERATOR_STEPS (NUM_BRICK_ROWS + 2)
+
+typedef struct {
+    uint32_t seed;
+    uint16_t depth;
+    bool started;
+    // Steps done so far
+    uint8_t step;
+    uint32_t random;
+
+    Level_Pattern pattern;
+    Fall_Style fall_style;
+    uint8_t base_health;
+    // Extra health of the top row, rows below get less
+    uint8_t gradient;
+    Level_Source source;
+
+    uint8_t packed[LEVEL_MAX_PACKED];
+    uint32_t packed_size;
+} Level_Generator;
+
+void generator_begin(Level_Generator *generator, uint32_t seed, uint16_t depth) {
+    generator->seed = seed;
+    generator->depth = depth;
+    generator->started = true;
+    generator->step = 0;
+}
+
+bool generator_done(const Level_Generator *generator) {
+    return generator->started && generator->step == LEVEL_GENERATOR_STEPS;
+}
+
+// Lives, speeds and how fast the bricks fall get harder with depth,
+// the pattern and the way the rows fall are picked at random
+void generate_settings(Level_Generator *generator) {
+    uint8_t key[] = {
+        (uint8_t) generator->seed, (uint8_t) (generator->seed >> 8),
+        (uint8_t) (generator->seed >> 16), (uint8_t) (generator->seed >> 24),
+        (uint8_t) generator->depth, (uint8_t) (generator->depth >> 8),
+    };
+    // xorshift32 never leaves 0
+    generator->random = hash_bytes(HASH_SEED, key, sizeof(key)) | 1;
+
+    int depth = generator->depth;
+    Level_Source *source = &generator->source;
+    memset(source, 0, sizeof(*source));
+    source->num_balls = (uint8_t) (5 - clamp_int(depth / 10, 0, 2));
+    source->ball_speed = (uint8_t) (7 + clamp_int(depth / 8, 0, 3));
+    source->fall_clock_size = (uint16_t) (420 - clamp_int(depth * 10, 0, 270));
+    if (depth >= 10) {
+        source->acceleration = (uint16_t) random_below(
+            &generator->random, (uint32_t) (1 + clamp_int((depth - 10) / 5, 0, 4)));
+    }
+
+    generator->pattern = (Level_Pattern) random_below(&generator->random, NUM_PATTERNS);
+    generator->fall_style = depth < 2 ? FALL_TOGETHER
+                          : (Fall_Style) random_below(&generator->random, NUM_FALL_STYLES);
+    generator->base_health = (uint8_t) (1 + clamp_int(depth / 3, 0, 8));
+    generator->gradient = (uint8_t) random_below(
+        &generator->random, (uint32_t) (1 + clamp_int(depth / 2, 0, 6)));
+}
+
+// Mirrored around the middle column
+void generate_row(Level_Generator *generator, int row) {
+    Level_Source *source = &generator->source;
+    int half = (NUM_BRICK_COLS + 1) / 2;
+    for (int col = 0; col < half; col++) {
+        // 0 for the middle column(s)
+        int distance = half - 1 - col;
+        bool present = true;
+        switch (generator->pattern) {
+        case PATTERN_CHECKER:
+            present = ((row + col) & 1) == 0;
+            break;
+        case PATTERN_PYRAMID:
+            present = distance <= row * half / NUM_BRICK_ROWS;
+            break;
+        case PATTERN_SCATTER:
+            present = random_below(&generator->random, 100) <
+                      (uint32_t) (55 + clamp_int(generator->depth, 0, 35));
+            break;
+        case PATTERN_SOLID:
+        case NUM_PATTERNS:
+        default:
+            break;
+        }
+        int health = 0;
+        if (present) {
+            health = generator->base_health + (int) random_below(&generator->random, 2) +
+                     generator->gradient * (NUM_BRICK_ROWS - 1 - row) / (NUM_BRICK_ROWS - 1);
+            health = clamp_int(health, 1, MAX_BRICK_HEALTH);
+        }
+        source->health[row * NUM_BRICK_COLS + col] = (uint8_t) health;
+        source->health[row * NUM_BRICK_COLS + NUM_BRICK_COLS - 1 - col] = (uint8_t) health;
+    }
+
+    Row_Fall_Schedule *schedule = &source->row_schedules[row];
+    switch (generator->fall_style) {
+    case FALL_BOTTOM_FIRST:
+        schedule->delay = (uint8_t) ((NUM_BRICK_ROWS - 1 - row) * 2);
+        break;
+    case FALL_TOP_SLOWER:
+        schedule->shift = (uint8_t) (row < NUM_BRICK_ROWS / 2);
+        break;
+    case FALL_TOGETHER:
+    case NUM_FALL_STYLES:
+    default:
+        break;
+    }
+}
+
+void generate_packed(Level_Generator *generator) {
+    Level_Source *source = &generator->source;
+    bool any = false;
+    for (int i = 0; i < NUM_BRICKS; i++) {
+        any |= source->health[i] > 0;
+    }
+    // Scattered levels can come out empty
+    if (!any) {
+        int bottom = (NUM_BRICK_ROWS - 1) * NUM_BRICK_COLS;
+        source->health[bottom + (NUM_BRICK_COLS - 1) / 2] = generator->base_health;
+        source->health[bottom + NUM_BRICK_COLS / 2] = generator->base_health;
+    }
+
+    Bit_Stream stream;
+    memset(generator->packed, 0, sizeof(generator->packed));
+    bits_begin(&stream, generator->packed, sizeof(generator->packed));
+    pack_level(source, &stream);
+    generator->packed_size = bits_size(&stream);
+}
+
+// Does the next bit of work, returns true once the level is packed
+bool generator_step(Level_Generator *generator) {
+    if (generator_done(generator)) {
+        return true;
+    }
+    if (generator->step == 0) {
+        generate_settings(generator);
+    } else if (generator->step <= NUM_BRICK_ROWS) {
+        generate_row(generator, generator->step - 1);
+    } else {
+        generate_packed(generator);
+    }
+    generator->step++;
+    return generator_done(generator);
+}
+
+#endif
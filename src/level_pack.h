@@ -0,0 +1,27 @@
+#include "level_format.h"
+#include "levels.h"
+
+#include <stdint.h>
+
+#ifndef LEVEL_PACK_H_
+#define LEVEL_PACK_H_
+
+// The levels compiled from levels/*.txt (build/gen/levels.h, see
+// native/level_compiler.c), packed back to back in the format of
+// level_format.h. A level is unpacked straight into the brick field
+// when it starts, so only the packed bytes of all of them are in the
+// cart.
+
+_Static_assert(NUM_LEVELS >= 1 && NUM_LEVELS <= 256, "The level pack has 1 to 256 levels");
+
+// i < NUM_LEVELS
+const uint8_t *packed_level(int i) {
+    return &level_pack[level_pack_offsets[i]];
+}
+
+uint32_t packed_level_size(int i) {
+    uint32_t end = i + 1 < NUM_LEVELS ? level_pack_offsets[i + 1] : LEVEL_PACK_SIZE;
+    return end - level_pack_offsets[i];
+}
+
+#endif
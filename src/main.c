@@ -1,8 +1,26 @@
+#include "arena.h"
+#include "balls.h"
+#include "bricks.h"
+#include "dirty_rects.h"
+#include "level_generator.h"
+#include "level_pack.h"
 #include "palettes.h"
+#include "particles.h"
+#include "perf_counters.h"
+#include "raster.h"
+#include "render_commands.h"
+#include "replay.h"
+#include "rollback.h"
+#include "save_state.h"
+#include "sprites.h"
+#include "stack_canary.h"
+#include "text_layout.h"
+#include "timestep.h"
 #include "utils.h"
 #include "wasm4.h"
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <string.h>
 
 #define PADDLE_WIDTH  32
@@ -11,44 +29,6 @@
 #define MIN_PADDLE_X  1
 #define MAX_PADDLE_X  (SCREEN_SIZE - MIN_PADDLE_X - PADDLE_WIDTH)
 
-#define BALL_DIAMETER      4
-#define BALL_VELOCITY_DOWN 1
-#define BALL_VELOCITY_UP  -1
-
-#define BRICK_INITIAL_X             2
-#define BRICK_INITIAL_Y             BALL_DIAMETER + 2
-#define BRICK_PAD                   1
-#define BRICK_WIDTH_PLUS_PADDING    26
-#define BRICK_HEIGHT_PLUS_PADDING   8
-#define BRICK_WIDTH                 (BRICK_WIDTH_PLUS_PADDING)  - (BRICK_PAD * 2)
-#define BRICK_HEIGHT                (BRICK_HEIGHT_PLUS_PADDING) - (BRICK_PAD * 2)
-#define NUM_BRICK_COLS              ((int) ((SCREEN_SIZE - (BRICK_INITIAL_X * 2)) / BRICK_WIDTH_PLUS_PADDING))
-#define NUM_BRICK_ROWS              8
-#define NUM_BRICKS                  (NUM_BRICK_COLS) * (NUM_BRICK_ROWS)
-
-static char temp_buffer[32];
-
-typedef struct {
-    int x;
-    int y;
-    int width;
-    int height;
-} Rect;
-
-typedef enum {
-    BHV_L_L, // -1 -1
-    BHV_N_L, //  0 -1
-    BHV_N_N, //  0  0
-    BHV_N_R, //  0  1
-    BHV_R_R, //  1  1
-    NUM_BHV
-} Ball_Horizontal_Velocity_Kind;
-
-typedef struct {
-    Ball_Horizontal_Velocity_Kind kind;
-    bool mode;
-} Ball_Horizontal_Velocity;
-
 typedef enum {
     HELP_SCREEN,
     GAME_SCREEN,
@@ -56,32 +36,37 @@ typedef enum {
     NUM_SCREEN
 } Screen_Kind;
 
-typedef struct {
-    uint8_t health;
-    int brick_x;
-    int brick_y;
-    Clock brick_fall_clock;
-} Brick;
-
 typedef enum {
-    LEVEL1,
-    LEVEL2,
-    LEVEL3,
-    LEVEL4,
-    LEVEL5,
-    LEVEL6,
-    LEVEL7,
-    LEVEL8,
-    NUM_LEVELS
-} Level;
+    SINGLE_BALL_MODE,
+    // Every destroyed brick releases another ball, a life is only
+    // lost once all of them are gone
+    MULTI_BALL_MODE,
+    NUM_GAME_MODES
+} Game_Mode;
 
-typedef enum {
-    RIGHT,
-    LEFT,
-    BOTTOM,
-    TOP,
-    NUM_DIRECTIONS
-} Direction;
+// Versus: player 2 on GAMEPAD2
+#define NUM_PLAYERS 2
+
+// Levels [0, NUM_LEVELS) are the ones of the level pack, the ones
+// after them are generated (only played in endless mode)
+typedef uint16_t Level;
+
+#define FIRST_LEVEL 0
+#define LAST_LEVEL  UINT16_MAX
+
+// Seed of the generated levels, native tools can pick another one
+// (e.g; one per day) before start()
+#define ENDLESS_SEED 0x2545f491u
+
+uint32_t endless_seed = ENDLESS_SEED;
+
+// Bricks of the arenas of a session, native tools can pick another
+// size (1 to ARENA_MAX_BRICKS) before start()
+#define ARENA_BRICKS 2400
+
+_Static_assert(ARENA_BRICKS <= ARENA_MAX_BRICKS, "The cart's arenas don't fit in Brick_Arena");
+
+int arena_num_bricks = ARENA_BRICKS;
 
 typedef struct {
     Screen_Kind screen_kind;
@@ -92,6 +77,15 @@ typedef struct {
 
     // Level
     Level level;
+    Game_Mode game_mode;
+    // Go on past the last level of the level pack, with generated
+    // levels, instead of starting over
+    bool endless;
+    uint32_t endless_seed;
+    // A game is in progress: its level was started on the game screen
+    // and isn't over. New games are only set up on the help screen
+    // when there's none, so pausing never loses one.
+    bool in_progress;
 
     // Lives
     uint8_t num_balls_left;
@@ -99,652 +93,1678 @@ typedef struct {
     // Paddle Position
     int paddle_x;
 
-    // Ball Position
-    int ball_x;
-    int ball_y;
-
-    // Ball Velocity
-    Ball_Horizontal_Velocity ball_velocity_x;
-    int ball_velocity_y;
-
-    Brick bricks[NUM_BRICKS];
+    Ball_Pool balls;
+    Brick_Field bricks;
+
+    // Versus: player 2 has a paddle of their own, ball i is player i's
+    // and only bounces off their paddle, and whoever broke the most
+    // bricks when the game ends wins. There are no lives, a lost ball
+    // is back on its paddle right away.
+    bool versus;
+    int paddle2_x;
+    uint8_t previous_gamepad2;
+    uint8_t bricks_broken[NUM_PLAYERS];
+    // Netplay (see netplay_advance()): the game has to fit in a rollback
+    // snapshot, so it stays single ball
+    bool netplay;
+
+    // Arena: the level's bricks are replaced by arena_bricks (which is
+    // left out of save states, an arena doesn't fit in one), of
+    // arena_num_bricks bricks. Not in versus or netplay.
+    bool arena;
+    uint16_t arena_num_bricks;
+
+    // The generated level being played or the next one, derived from
+    // the level and seed (so it's left out of checksums and saves)
+    Level_Generator generator;
+
+    // Generated from the level and seed (only when arena is on)
+    Brick_Arena arena_bricks;
 } Game_State;
 
-void update_ball_velocity_x_to_left(Game_State *state) {
-    switch (state->ball_velocity_x.kind) {
-    case BHV_N_L:
-        state->ball_velocity_x.kind = BHV_L_L;
-        state->ball_velocity_x.mode = false;
-        break;
-    case BHV_N_N:
-        state->ball_velocity_x.kind = BHV_N_L;
-        state->ball_velocity_x.mode = false;
-        break;
-    case BHV_N_R:
-        state->ball_velocity_x.kind = BHV_N_N;
-        state->ball_velocity_x.mode = false;
-        break;
-    case BHV_R_R:
-        state->ball_velocity_x.kind = BHV_N_R;
-        state->ball_velocity_x.mode = false;
-        break;
-    default:
-        break;
+#define MAX_BROKEN_BRICKS 8
+
+// What steps of the game did that the state doesn't hold but that has
+// to be shown or heard. Steps add to it until it's taken care of.
+typedef struct {
+    // Everything on screen changed
+    bool full_repaint;
+    // Regions of GAME_SCREEN that changed
+    Dirty_Rects dirty;
+    bool brick_hit;
+    // Top of the view on the world (see world_to_screen()), what is
+    // marked dirty is on screen that much higher
+    int view_y;
+    // Bricks broken (in world coordinates) for their particles, the
+    // ones past MAX_BROKEN_BRICKS go without
+    Rect broken[MAX_BROKEN_BRICKS];
+    uint8_t num_broken;
+} Game_Events;
+
+// events is NULL when nothing is drawn (e.g; batch simulations), r is
+// in world coordinates
+void mark_dirty(Game_Events *events, Rect r) {
+    if (events) {
+        r.y -= events->view_y;
+        dirty_add(&events->dirty, r);
     }
 }
 
-void update_ball_velocity_x_to_right(Game_State *state) {
-    switch (state->ball_velocity_x.kind) {
-    case BHV_L_L:
-        state->ball_velocity_x.kind = BHV_N_L;
-        state->ball_velocity_x.mode = false;
-        break;
-    case BHV_N_L:
-        state->ball_velocity_x.kind = BHV_N_N;
-        state->ball_velocity_x.mode = false;
-        break;
-    case BHV_N_N:
-        state->ball_velocity_x.kind = BHV_N_R;
-        state->ball_velocity_x.mode = false;
-        break;
-    case BHV_N_R:
-        state->ball_velocity_x.kind = BHV_R_R;
-        state->ball_velocity_x.mode = false;
-        break;
-    default:
-        break;
+void note_broken_brick(Game_Events *events, Rect r) {
+    if (events && events->num_broken < MAX_BROKEN_BRICKS) {
+        events->broken[events->num_broken++] = r;
     }
 }
 
-void reflect_velocity_x_to_left(Game_State *state) {
-    switch (state->ball_velocity_x.kind) {
-    case BHV_N_R:
-        state->ball_velocity_x.kind = BHV_N_L;
-        state->ball_velocity_x.mode = false;
-        break;
-    case BHV_R_R:
-        state->ball_velocity_x.kind = BHV_L_L;
-        state->ball_velocity_x.mode = false;
-        break;
-    default:
-        break;
+void mark_all_dirty(Game_Events *events) {
+    if (events) {
+        events->full_repaint = true;
     }
 }
 
-void reflect_velocity_x_to_right(Game_State *state) {
-    switch (state->ball_velocity_x.kind) {
-    case BHV_N_L:
-        state->ball_velocity_x.kind = BHV_N_R;
-        state->ball_velocity_x.mode = false;
-        break;
-    case BHV_L_L:
-        state->ball_velocity_x.kind = BHV_R_R;
-        state->ball_velocity_x.mode = false;
-        break;
-    default:
-        break;
+// What is currently on screen, used to repaint only what changed
+// on GAME_SCREEN (the framebuffer is preserved between frames)
+typedef struct {
+    Screen_Kind screen_kind;
+    int paddle_x;
+    int paddle2_x;
+    uint8_t num_balls_left;
+    // Since the last frame drawn
+    Game_Events events;
+    Render_Buffer commands;
+} Renderer;
+
+Renderer renderer = {0};
+
+// Particles of the cart, 14 KiB of its 64 KiB. Native tools can give
+// the pool more room after start().
+#define PARTICLE_CAPACITY    2048
+#define PARTICLES_PER_BRICK  12
+_Alignas(int16_t) uint8_t particle_storage[PARTICLE_CAPACITY * PARTICLE_BYTES];
+Particle_Pool particles = {0};
+
+// Earliest hit of a ball moving by (dx, dy) on an alive brick, returns
+// that brick (the first in grid order on ties) or -1.
+// The bricks form a uniform grid, so the area the ball sweeps maps
+// straight to the few rows and columns it can touch; only alive bricks
+// in those cells go through sweep_ball_rect(). Rows are bounded using
+// the least and most any row has fallen, which is a single offset
+// unless the level has rows falling at different rates.
+int sweep_bricks(const Brick_Field *bricks, Fixed x, Fixed y, Fixed dx, Fixed dy,
+                 Sweep_Hit *hit) {
+    Rect swept = {
+        .x=fixed_floor(dx < 0 ? x + dx : x),
+        .y=fixed_floor(dy < 0 ? y + dy : y),
+    };
+    swept.width = fixed_ceil(dx < 0 ? x : x + dx) + BALL_DIAMETER - swept.x;
+    swept.height = fixed_ceil(dy < 0 ? y : y + dy) + BALL_DIAMETER - swept.y;
+
+    // Bricks merely touching the swept area are included, they are
+    // rejected by sweep_ball_rect()
+    int grid_top = BRICK_PAD + BRICK_INITIAL_Y;
+    int first_row = floor_div(swept.y - grid_top - (BRICK_HEIGHT) - bricks->max_row_fall,
+                              BRICK_HEIGHT_PLUS_PADDING);
+    int last_row = floor_div(swept.y + swept.height - grid_top - bricks->min_row_fall,
+                             BRICK_HEIGHT_PLUS_PADDING);
+    if (first_row < 0) first_row = 0;
+    if (last_row > NUM_BRICK_ROWS - 1) last_row = NUM_BRICK_ROWS - 1;
+    if (first_row > last_row) {
+        return -1;
     }
-}
 
-void update_ball_velocity_based_on_direction(Game_State *state, Direction dir) {
-    switch(dir) {
-    case TOP:
-        if (state->ball_velocity_y != 0) {
-            state->ball_velocity_y = BALL_VELOCITY_DOWN;
-        }
-        break;
-    case BOTTOM:
-        if (state->ball_velocity_y != 0) {
-            state->ball_velocity_y = BALL_VELOCITY_UP;
+    int grid_left = BRICK_PAD + BRICK_INITIAL_X;
+    int first_col = floor_div(swept.x - grid_left - (BRICK_WIDTH), BRICK_WIDTH_PLUS_PADDING);
+    int last_col = floor_div(swept.x + swept.width - grid_left, BRICK_WIDTH_PLUS_PADDING);
+    if (first_col < 0) first_col = 0;
+    if (last_col > NUM_BRICK_COLS - 1) last_col = NUM_BRICK_COLS - 1;
+    if (first_col > last_col) {
+        return -1;
+    }
+    Brick_Row_Mask cols = (Brick_Row_Mask) (((1 << (last_col + 1)) - 1) & ~((1 << first_col) - 1));
+
+    int found = -1;
+    Sweep_Hit candidate;
+    for (int row = first_row; row <= last_row; row++) {
+        for (Brick_Row_Mask mask = bricks->alive_rows[row] & cols; mask; mask &= mask - 1) {
+            int i = row * NUM_BRICK_COLS + __builtin_ctz(mask);
+            PERF_COUNT(PERF_BRICK_TESTS);
+            if (sweep_ball_rect(x, y, dx, dy, brick_rect(bricks, i), &candidate) &&
+                (found < 0 || candidate.time < hit->time)) {
+                *hit = candidate;
+                found = i;
+            }
         }
-        break;
-    case LEFT:
-        reflect_velocity_x_to_right(state);
-        break;
-    case RIGHT:
-        reflect_velocity_x_to_left(state);
-        break;
-    case NUM_DIRECTIONS:
-    default:
-        panicf("Unreachable! Invalid Direction: %d", dir);
-        break;
     }
+    return found;
 }
 
-// Checks if Other bbox is colliding with Focus bbox
-// From Top, Bottom, Left or Right
-// Top    -> Other object is above the focus
-// Bottom -> Other object is below the focus
-// Left   -> Other object is left of the focus
-// Right  -> Other object is right of the focus
-bool bbox_colliding(Rect focus, Rect other, Direction *direction) {
-    if (
-        (!overlap(focus.x, focus.x + focus.width,
-                  other.x, other.x + other.width)) ||
-        (!overlap(focus.y, focus.y + focus.height,
-                  other.y, other.y + other.height))
-    ) {
-        return false;
+// The bricks being played are the level's, or the arena's in an arena.
+// A brick is its index in either.
+int sweep_game_bricks(const Game_State *state, Fixed x, Fixed y, Fixed dx, Fixed dy,
+                      Sweep_Hit *hit) {
+    if (state->arena) {
+        return sweep_arena(&state->arena_bricks, x, y, dx, dy, hit);
     }
+    return sweep_bricks(&state->bricks, x, y, dx, dy, hit);
+}
 
-    if (direction) {
-        int overlap_right  = (focus.x + focus.width)  - other.x;
-        int overlap_left   = (other.x + other.width)  - focus.x;
-        int overlap_bottom = (focus.y + focus.height) - other.y;
-        int overlap_top    = (other.y + other.height) - focus.y;
-
-        int min_overlap = overlap_left;
-
-        if (overlap_right < min_overlap)  min_overlap = overlap_right;
-        if (overlap_top < min_overlap)    min_overlap = overlap_top;
-        if (overlap_bottom < min_overlap) min_overlap = overlap_bottom;
+Rect game_brick_rect(const Game_State *state, int i) {
+    return state->arena ? arena_brick_rect(&state->arena_bricks, i) : brick_rect(&state->bricks, i);
+}
 
-        if (min_overlap == overlap_top) {
-            *direction = TOP;
-        } else if (min_overlap == overlap_bottom) {
-            *direction = BOTTOM;
-        } else if (min_overlap == overlap_left) {
-            *direction = LEFT;
-        } else {
-            *direction = RIGHT;
-        }
-    }
+bool damage_game_brick(Game_State *state, int i) {
+    return state->arena ? damage_arena_brick(&state->arena_bricks, i) :
+                          damage_brick(&state->bricks, i);
+}
 
-    return true;
+int count_bricks(const Game_State *state) {
+    return state->arena ? state->arena_bricks.num_bricks : NUM_BRICKS;
 }
 
 int count_alive_bricks(const Game_State *state) {
-    int count = 0;
-    for (int i = 0; i < NUM_BRICKS; i++) {
-        if (state->bricks[i].health > 0) {
-            count++;
-        }
-    }
-    return count;
+    return state->arena ? state->arena_bricks.num_alive : state->bricks.num_alive;
 }
 
 bool any_brick_alive(const Game_State *state) {
-    bool any_brick_alive = false;
-    for (int i = 0; i < NUM_BRICKS; i++) {
-        if (state->bricks[i].health > 0) {
-            any_brick_alive = true;
-            break;
-        }
-    }
-    return any_brick_alive;
+    return count_alive_bricks(state) > 0;
 }
 
 bool any_brick_crossed_or_touched_paddle(const Game_State *state) {
-    bool flg = false;
-    for (int i = 0; i < NUM_BRICKS; i++) {
-        if ((state->bricks[i].health > 0) &&
-            (state->bricks[i].brick_y + BRICK_HEIGHT >= PADDLE_Y)) {
-            flg = true;
-            break;
-        }
-    }
-    return flg;
+    return !state->arena && state->bricks.num_alive > 0 &&
+           state->bricks.lowest_bottom >= PADDLE_Y;
 }
 
+// Leaves a single ball resting on the paddle
 void reset_ball(Game_State *state) {
-    state->ball_x = state->paddle_x + (PADDLE_WIDTH >> 1) - (BALL_DIAMETER >> 1);
-    state->ball_y = PADDLE_Y - BALL_DIAMETER;
-    state->ball_velocity_x.kind = BHV_N_N;
-    state->ball_velocity_x.mode = false;
-    state->ball_velocity_y = 0;
+    state->balls.count = 0;
+    spawn_ball(&state->balls,
+               state->paddle_x + (PADDLE_WIDTH >> 1) - (BALL_DIAMETER >> 1),
+               PADDLE_Y - BALL_DIAMETER, 0, 0);
 }
 
-void reset_bricks(Game_State *state) {
-    for (int i = 0; i < NUM_BRICKS; i++) {
-        int x = i % NUM_BRICK_COLS;
-        int y = i / NUM_BRICK_COLS;
-        state->bricks[i].brick_fall_clock.clock = 0;
-        state->bricks[i].brick_fall_clock.cycled = false;
-        switch(state->level) {
-        case LEVEL1:
-            state->bricks[i].health = 1;
-            state->bricks[i].brick_fall_clock.clock_size = 0;
-            break;
-        case LEVEL2:
-            state->bricks[i].health = 2;
-            state->bricks[i].brick_fall_clock.clock_size = 0;
-            break;
-        case LEVEL3:
-            state->bricks[i].health = 3;
-            state->bricks[i].brick_fall_clock.clock_size = 300;
-            break;
-        case LEVEL4:
-            state->bricks[i].health = 4;
-            state->bricks[i].brick_fall_clock.clock_size = 300;
-            break;
-        case LEVEL5:
-            state->bricks[i].health = 5;
-            state->bricks[i].brick_fall_clock.clock_size = 360;
-            break;
-        case LEVEL6:
-            state->bricks[i].health = 6;
-            state->bricks[i].brick_fall_clock.clock_size = 360;
-            break;
-        case LEVEL7:
-            state->bricks[i].health = 7;
-            state->bricks[i].brick_fall_clock.clock_size = 420;
-            break;
-        case LEVEL8:
-            state->bricks[i].health = 8;
-            state->bricks[i].brick_fall_clock.clock_size = 420;
-            break;
-        case NUM_LEVELS:
-        default:
-            panicf("Unreachable! Invalid level: %d", state->level);
-            break;
-        }
-        state->bricks[i].brick_x = (
-            BRICK_PAD + BRICK_INITIAL_X + x * BRICK_WIDTH_PLUS_PADDING);
-        state->bricks[i].brick_y = (
-            BRICK_PAD + BRICK_INITIAL_Y + y * BRICK_HEIGHT_PLUS_PADDING);
-    }
+// Player 0 is the one on GAMEPAD1
+int player_paddle_x(const Game_State *state, int player) {
+    return player == 0 ? state->paddle_x : state->paddle2_x;
 }
 
-void reset_level(Game_State *state) {
-    switch(state->level) {
-    case LEVEL1:
-    case LEVEL2:
-        state->num_balls_left = 3;
-        break;
-    case LEVEL3:
-    case LEVEL4:
-    case LEVEL5:
-        state->num_balls_left = 4;
-        break;
-    case LEVEL6:
-    case LEVEL7:
-    case LEVEL8:
-        state->num_balls_left = 5;
-        break;
-    case NUM_LEVELS:
-    default:
-        panicf("Unreachable! Invalid level: %d", state->level);
-        break;
-    }
-    state->paddle_x = MIN_PADDLE_X;
-    reset_ball(state);
-    reset_bricks(state);
+// Whose ball i is
+int ball_player(const Game_State *state, int i) {
+    return state->versus ? i : 0;
 }
 
-Game_State state = {0};
-
-// Clears the background with a particular
-// color from the current set palette
-// color_index are values from 1-4
-// corresponding to 4 colors in the palette
-void clear_background() {
-    int palette_color = *DRAW_COLORS & 0b1111;
-    short color_index = (palette_color - 1) & 0b11;
-    memset(FRAMEBUFFER,
-           color_index | (color_index << 2) | (color_index << 4) | (color_index << 6),
-           SCREEN_SIZE*SCREEN_SIZE/4);
+// The player's ball sitting on their paddle waiting to be launched
+bool player_ball_resting(const Game_State *state, int player) {
+    if (!state->versus) {
+        return ball_resting(&state->balls);
+    }
+    return state->balls.velocity_y[player] == 0;
 }
 
-void start() {
-    state.screen_kind = HELP_SCREEN;
-    // state.screen_kind = GAME_SCREEN;
-    // state.screen_kind = GAME_OVER_SCREEN;
-    state.frame_clock.clock = 0;
-    state.frame_clock.clock_size = 60;
-    state.current_palette = ICE_CREAM_GB;
-    state.level = LEVEL1;
-    reset_level(&state);
-    set_palette(state.current_palette);
+// Puts ball i back on its player's paddle, in versus
+void rest_ball_on_paddle(Game_State *state, int i) {
+    Ball_Pool *balls = &state->balls;
+    int paddle_x = player_paddle_x(state, ball_player(state, i));
+    balls->x[i] = int_to_fixed(paddle_x + (PADDLE_WIDTH >> 1) - (BALL_DIAMETER >> 1));
+    balls->y[i] = int_to_fixed(PADDLE_Y - BALL_DIAMETER);
+    balls->velocity_x[i] = 0;
+    balls->velocity_y[i] = 0;
 }
 
-// *DRAW_COLORS = 0xABCD;
-// D: Fill Color (0 - 5)
-// C: Stroke Color (0 - 5)&
-// A and B currently unknown
-// ---
-// 0: TRANSPARENT
-// 1: PALETTE[0] i.e; Color 1
-// 2: PALETTE[1] i.e; Color 2
-// 3: PALETTE[2] i.e; Color 3
-// 4: PALETTE[3] i.e; Color 4
+// Packed bytes of a level, a generated one is generated right away if
+// it wasn't already (see generate_next_level())
+const uint8_t *level_data(Game_State *state, uint32_t *size) {
+    if (state->level < NUM_LEVELS) {
+        *size = packed_level_size(state->level);
+        return packed_level(state->level);
+    }
+    Level_Generator *generator = &state->generator;
+    uint16_t depth = (uint16_t) (state->level - NUM_LEVELS);
+    if (!generator->started || generator->seed != state->endless_seed ||
+        generator->depth != depth) {
+        generator_begin(generator, state->endless_seed, depth);
+    }
+    while (!generator_step(generator)) {}
+    *size = generator->packed_size;
+    return generator->packed;
+}
 
-void update() {
-    uint8_t gamepad = *GAMEPAD1;
-    uint8_t pressed_this_frame = gamepad & (gamepad ^ state.previous_gamepad);
+// Vertical speed of the ball, in sub-pixels per frame
+Fixed level_ball_speed(Game_State *state) {
+    uint32_t size;
+    return packed_level_ball_speed(level_data(state, &size));
+}
 
-    // Palette Switch
-    if (pressed_this_frame & BUTTON_1) {
-        state.current_palette = (state.current_palette + 1) % NUM_PALETTE_PICKER;
-        set_palette(state.current_palette);
+// Where the game goes on after the game over screen: the same level
+// unless it was cleared
+Level next_level(const Game_State *state) {
+    if (any_brick_alive(state)) {
+        return state->level;
     }
-    *DRAW_COLORS = 0x02;
-    clear_background();
+    if (state->endless) {
+        return state->level < LAST_LEVEL ? (Level) (state->level + 1) : LAST_LEVEL;
+    }
+    return state->level + 1 < NUM_LEVELS ? (Level) (state->level + 1) : FIRST_LEVEL;
+}
 
-    // Switch Screen Logic
-    if (pressed_this_frame & BUTTON_DOWN) {
-        state.screen_kind = HELP_SCREEN;
+// Generates the next level a step per frame while the game over
+// screen is up, so that it's ready (and no frame took long for it)
+// by the time it's played
+void generate_next_level(Game_State *state) {
+    Level level = next_level(state);
+    if (level < NUM_LEVELS) {
+        return;
     }
-    if (state.screen_kind == GAME_OVER_SCREEN) {
-        if (pressed_this_frame & BUTTON_UP) {
-            if (!any_brick_alive(&state)) {
-                state.level = (state.level + 1) % NUM_LEVELS;
-            }
-            reset_level(&state);
-            state.screen_kind = GAME_SCREEN;
-            return;
-        }
+    Level_Generator *generator = &state->generator;
+    uint16_t depth = (uint16_t) (level - NUM_LEVELS);
+    if (!generator->started || generator->seed != state->endless_seed ||
+        generator->depth != depth) {
+        generator_begin(generator, state->endless_seed, depth);
     } else {
-        if (pressed_this_frame & BUTTON_UP) {
-            state.screen_kind = GAME_SCREEN;
-        }
+        generator_step(generator);
     }
+}
 
-    switch (state.screen_kind) {
-    case HELP_SCREEN: {
-        int text_x = 5;
-        int text_y = 5;
-        int text_ypad = 3;
+void reset_level(Game_State *state) {
+    uint32_t size;
+    const uint8_t *level = level_data(state, &size);
+    state->num_balls_left = packed_level_num_balls(level);
+    state->paddle_x = MIN_PADDLE_X;
+    reset_ball(state);
+    if (state->versus) {
+        // Player 2 starts on the other side
+        state->num_balls_left = 0;
+        state->paddle2_x = MAX_PADDLE_X;
+        state->balls.count = NUM_PLAYERS;
+        rest_ball_on_paddle(state, 1);
+        memset(state->bricks_broken, 0, sizeof(state->bricks_broken));
+    }
+    state->in_progress = false;
+    unpack_level_bricks(level, size, &state->bricks);
+    if (state->arena) {
+        generate_arena(&state->arena_bricks, state->arena_num_bricks,
+                       hash_bytes(state->endless_seed, &state->level, sizeof(state->level)));
+    }
+}
 
-        {
-            *DRAW_COLORS = 0x04;
-            text("Welcome to the", text_x, text_y);
+// Puts a game where a session starts (what a replay starts from)
+void game_reset(Game_State *state, Level level, Palette_Picker palette, Game_Mode game_mode,
+                uint32_t seed, int arena_num_bricks) {
+    state->screen_kind = HELP_SCREEN;
+    // state->screen_kind = GAME_SCREEN;
+    // state->screen_kind = GAME_OVER_SCREEN;
+    clock_reset(&state->frame_clock);
+    state->frame_clock.clock_size = 60;
+    state->previous_gamepad = 0;
+    state->previous_gamepad2 = 0;
+    state->current_palette = palette;
+    state->game_mode = game_mode;
+    state->endless = false;
+    state->versus = false;
+    state->netplay = false;
+    state->arena = false;
+    state->arena_num_bricks = (uint16_t) arena_num_bricks;
+    state->endless_seed = seed;
+    state->level = level;
+    reset_level(state);
+}
 
-            text_y += FONT_SIZE + text_ypad;
-            text("Brick Breaker!", text_x, text_y);
-        }
+Game_State state = {0};
 
-        text_y += FONT_SIZE + text_ypad;
-        text_y += FONT_SIZE + text_ypad;
+// Everything update() depends on, i.e; two states with the same
+// checksum play out the same from there on given the same input
+uint32_t game_state_checksum(const Game_State *state) {
+    uint8_t header[] = {
+        (uint8_t) state->screen_kind, state->previous_gamepad,
+        (uint8_t) state->current_palette, (uint8_t) state->game_mode,
+        state->endless, state->num_balls_left, state->frame_clock.cycled,
+        state->in_progress, state->netplay,
+    };
+    uint32_t hash = hash_bytes(HASH_SEED, header, sizeof(header));
+    hash = hash_bytes(hash, &state->level, sizeof(state->level));
+    hash = hash_bytes(hash, &state->endless_seed, sizeof(state->endless_seed));
+    hash = hash_bytes(hash, &state->arena_num_bricks, sizeof(state->arena_num_bricks));
+    hash = hash_bytes(hash, &state->frame_clock.clock, sizeof(state->frame_clock.clock));
+    hash = hash_bytes(hash, &state->paddle_x, sizeof(state->paddle_x));
+
+    const Ball_Pool *balls = &state->balls;
+    hash = hash_bytes(hash, &balls->count, sizeof(balls->count));
+    hash = hash_bytes(hash, balls->x, balls->count * sizeof(balls->x[0]));
+    hash = hash_bytes(hash, balls->y, balls->count * sizeof(balls->y[0]));
+    hash = hash_bytes(hash, balls->velocity_x, balls->count * sizeof(balls->velocity_x[0]));
+    hash = hash_bytes(hash, balls->velocity_y, balls->count * sizeof(balls->velocity_y[0]));
+
+    const Brick_Field *bricks = &state->bricks;
+    hash = hash_bytes(hash, bricks->health, sizeof(bricks->health));
+    hash = hash_bytes(hash, bricks->alive_rows, sizeof(bricks->alive_rows));
+    hash = hash_bytes(hash, bricks->row_schedules, sizeof(bricks->row_schedules));
+    const Fall_Scheduler *fall = &bricks->fall;
+    uint16_t fall_fields[] = {
+        fall->clock.clock, fall->clock.clock_size, fall->clock.cycled,
+        fall->cycles, fall->acceleration,
+    };
+    hash = hash_bytes(hash, fall_fields, sizeof(fall_fields));
+
+    // Single player checksums stay what they were before versus
+    if (state->versus) {
+        uint8_t versus[] = {
+            (uint8_t) state->paddle2_x, state->previous_gamepad2,
+            state->bricks_broken[0], state->bricks_broken[1],
+        };
+        hash = hash_bytes(hash, versus, sizeof(versus));
+    }
+    if (state->arena) {
+        const Brick_Arena *arena = &state->arena_bricks;
+        hash = hash_bytes(hash, &arena->num_bricks, sizeof(arena->num_bricks));
+        hash = hash_bytes(hash, arena->health, (uint32_t) (arena->num_rows * NUM_BRICK_COLS + 1) / 2);
+    }
+    return hash;
+}
 
-        {
-            *DRAW_COLORS = 0x03;
-            text("Click on x", text_x, text_y);
+typedef enum {
+    REPLAY_NONE,
+    REPLAY_MATCHED,
+    // Ended with a different game state checksum than recorded
+    REPLAY_DIVERGED,
+} Replay_Result;
+
+// The session being recorded (saved to disk on game over) and the
+// replay being played back instead of GAMEPAD1, if any
+typedef struct {
+    // Followed by room for recording_capacity runs. The cart records
+    // into recording_buffer, native tools can give it a bigger one
+    // before start().
+    Replay_Header *recording;
+    uint32_t recording_capacity;
+    // A replay starts from a fresh game, so a session resumed from a
+    // save state isn't recorded
+    bool recording_on;
+    // The recording stopped there, its checksum is already set
+    bool recording_full;
+
+    bool playing;
+    // The replay is of the disk and the player's game is in the disk's
+    // save state, to be picked up again once the replay is over
+    bool resume_save;
+    Replay_Player player;
+    Replay_Result result;
+} Replays;
+
+Replay_Disk recording_buffer = {0};
+Replays replays = {
+    .recording=&recording_buffer.header,
+    .recording_capacity=REPLAY_DISK_RUNS,
+};
+
+Replay_Run *recording_runs() {
+    return (Replay_Run *) (replays.recording + 1);
+}
 
-            text_y += FONT_SIZE + text_ypad;
-            text("to switch the color", text_x, text_y);
+// Frames of play between save states
+#define SAVE_INTERVAL   600
+// Multi-ball games only save this many of their balls
+#define MAX_SAVED_BALLS 16
 
-            text_y += FONT_SIZE + text_ypad;
-            text("palette.", text_x, text_y);
-        }
+// In memory copy of the disk. diskw() replaces the whole disk, so it
+// is always written back as a whole (up to the end of the replay).
+typedef struct {
+    uint8_t save_state[SAVE_STATE_DISK_SIZE];
+    Replay_Disk replay;
+} Disk_Image;
 
-        text_y += FONT_SIZE + text_ypad;
-        text_y += FONT_SIZE + text_ypad;
+_Static_assert(sizeof(Disk_Image) <= 1024, "Disk_Image doesn't fit on the disk");
 
-        {
-            *DRAW_COLORS = 0x01;
-            text("Press up arrow to", text_x, text_y);
+typedef struct {
+    Disk_Image image;
+    // Something changed that has to be written at the end of the frame
+    bool changed;
+    uint16_t frames_since_save;
+} Disk;
+
+Disk disk = {0};
+
+void write_disk() {
+    uint32_t size = SAVE_STATE_DISK_SIZE;
+    if (replay_valid(&disk.image.replay.header, REPLAY_DISK_SIZE)) {
+        size += (uint32_t) (sizeof(Replay_Header) +
+                            disk.image.replay.header.num_runs * sizeof(Replay_Run));
+    }
+    diskw(&disk.image, size);
+    disk.changed = false;
+}
 
-            text_y += FONT_SIZE + text_ypad;
-            text("start the game!", text_x, text_y);
+_Static_assert(NUM_SCREEN <= 4, "Screen_Kind doesn't fit its save state field");
+_Static_assert(NUM_GAME_MODES <= 2, "Game_Mode doesn't fit its save state field");
+_Static_assert(NUM_PALETTE_PICKER <= 8, "Palette_Picker doesn't fit its save state field");
+_Static_assert(MAX_PADDLE_X < 256, "The paddle doesn't fit its save state field");
+_Static_assert(MAX_BRICK_HEALTH < 16, "Brick health doesn't fit its save state field");
+_Static_assert(MAX_SAVED_BALLS < 32, "The ball count doesn't fit its save state field");
+_Static_assert(NUM_BRICKS < 256, "bricks_broken doesn't fit its save state field");
+_Static_assert(NUM_PLAYERS <= MAX_SAVED_BALLS, "A versus game doesn't fit in a save state");
+
+// True if a save state holds all of the game. Multi-ball games past
+// MAX_SAVED_BALLS balls are saved without the extra ones, which is
+// fine for autosaves but not to put a game aside and bring it back.
+bool game_fits_save_state(const Game_State *state) {
+    return !state->arena && state->balls.count <= MAX_SAVED_BALLS;
+}
+
+// True if load_game_state() takes the saved fields of state back. Both
+// sides check it, so that a save state that was written always loads.
+bool saved_fields_valid(const Game_State *state) {
+    return state->screen_kind < NUM_SCREEN && state->current_palette < NUM_PALETTE_PICKER &&
+           (state->level < NUM_LEVELS || state->endless) && state->paddle_x >= MIN_PADDLE_X &&
+           state->paddle_x <= MAX_PADDLE_X &&
+           (!state->versus || (state->paddle2_x >= MIN_PADDLE_X &&
+                               state->paddle2_x <= MAX_PADDLE_X &&
+                               state->balls.count == NUM_PLAYERS));
+}
+
+// Packs a state into a SAVE_STATE_DISK_SIZE byte save state, returns
+// false if it doesn't fit (an arena never does) or wouldn't load again.
+// Fields are in the order they are declared in, with the derived ones
+// (e.g; which bricks are alive) left out.
+bool save_game_state(const Game_State *state, uint8_t *save_state) {
+    if (state->arena || !saved_fields_valid(state)) {
+        return false;
+    }
+    Bit_Stream stream;
+    bits_begin(&stream, save_state + sizeof(Save_State_Header), SAVE_STATE_MAX_PACKED);
+    bits_write(&stream, state->screen_kind, 2);
+    bits_write(&stream, state->frame_clock.clock, 8);
+    bits_write(&stream, state->frame_clock.cycled, 1);
+    bits_write(&stream, state->current_palette, 3);
+    bits_write(&stream, state->level, 16);
+    bits_write(&stream, state->game_mode, 1);
+    bits_write(&stream, state->endless, 1);
+    bits_write(&stream, state->endless_seed, 32);
+    bits_write(&stream, state->in_progress, 1);
+    bits_write(&stream, state->num_balls_left, 8);
+    bits_write(&stream, (uint32_t) state->paddle_x, 8);
+    bits_write(&stream, state->versus, 1);
+    if (state->versus) {
+        bits_write(&stream, (uint32_t) state->paddle2_x, 8);
+        for (int player = 0; player < NUM_PLAYERS; player++) {
+            bits_write(&stream, state->bricks_broken[player], 8);
         }
+    }
 
-        text_y += FONT_SIZE + text_ypad;
-        text_y += FONT_SIZE + text_ypad;
+    const Ball_Pool *balls = &state->balls;
+    int num_balls = balls->count < MAX_SAVED_BALLS ? balls->count : MAX_SAVED_BALLS;
+    bits_write(&stream, (uint32_t) num_balls, 5);
+    for (int i = 0; i < num_balls; i++) {
+        // Up to 512 pixels either way
+        bits_write_signed(&stream, balls->x[i], 18);
+        bits_write_signed(&stream, balls->y[i], 18);
+        bits_write_signed(&stream, balls->velocity_x[i], 16);
+        bits_write_signed(&stream, balls->velocity_y[i], 16);
+    }
 
-        {
-            *DRAW_COLORS = 0x03;
-            text("Press down arrow", text_x, text_y);
+    const Brick_Field *bricks = &state->bricks;
+    for (int i = 0; i < NUM_BRICKS; i++) {
+        bits_write(&stream, brick_health(bricks, i), 4);
+    }
+    for (int row = 0; row < NUM_BRICK_ROWS; row++) {
+        bits_write(&stream, bricks->row_schedules[row].delay, 8);
+        bits_write(&stream, bricks->row_schedules[row].shift, 3);
+    }
+    bits_write(&stream, bricks->fall.clock.clock, 16);
+    bits_write(&stream, bricks->fall.clock.clock_size, 16);
+    bits_write(&stream, bricks->fall.clock.cycled, 1);
+    bits_write(&stream, bricks->fall.cycles, 16);
+    bits_write(&stream, bricks->fall.acceleration, 16);
 
-            text_y += FONT_SIZE + text_ypad;
-            text("in game to open", text_x, text_y);
+    if (stream.overflowed) {
+        return false;
+    }
+    save_state_seal(save_state, (uint16_t) bits_size(&stream));
+    return true;
+}
 
-            text_y += FONT_SIZE + text_ypad;
-            text("this help", text_x, text_y);
+// Unpacks a save state into state, returns false if it isn't valid
+// (state is left half written then)
+bool load_game_state(Game_State *state, uint8_t *save_state) {
+    int size = save_state_validate(save_state);
+    if (size < 0) {
+        return false;
+    }
+    Bit_Stream stream;
+    bits_begin(&stream, save_state + sizeof(Save_State_Header), (uint32_t) size);
+    state->screen_kind = (Screen_Kind) bits_read(&stream, 2);
+    state->frame_clock.clock = (uint16_t) bits_read(&stream, 8);
+    state->frame_clock.clock_size = 60;
+    state->frame_clock.cycled = bits_read(&stream, 1);
+    state->previous_gamepad = 0;
+    state->current_palette = (Palette_Picker) bits_read(&stream, 3);
+    state->level = (Level) bits_read(&stream, 16);
+    state->game_mode = (Game_Mode) bits_read(&stream, 1);
+    state->endless = bits_read(&stream, 1);
+    state->endless_seed = bits_read(&stream, 32);
+    state->in_progress = bits_read(&stream, 1);
+    state->num_balls_left = (uint8_t) bits_read(&stream, 8);
+    state->paddle_x = (int) bits_read(&stream, 8);
+    state->versus = bits_read(&stream, 1);
+    state->paddle2_x = MAX_PADDLE_X;
+    state->previous_gamepad2 = 0;
+    memset(state->bricks_broken, 0, sizeof(state->bricks_broken));
+    state->netplay = false;
+    state->arena = false;
+    if (state->versus) {
+        state->paddle2_x = (int) bits_read(&stream, 8);
+        for (int player = 0; player < NUM_PLAYERS; player++) {
+            state->bricks_broken[player] = (uint8_t) bits_read(&stream, 8);
         }
+    }
 
-        break;
+    Ball_Pool *balls = &state->balls;
+    balls->count = (uint16_t) bits_read(&stream, 5);
+    if (balls->count > MAX_SAVED_BALLS || !saved_fields_valid(state)) {
+        return false;
+    }
+    for (int i = 0; i < balls->count; i++) {
+        balls->x[i] = bits_read_signed(&stream, 18);
+        balls->y[i] = bits_read_signed(&stream, 18);
+        balls->velocity_x[i] = (int16_t) bits_read_signed(&stream, 16);
+        balls->velocity_y[i] = (int16_t) bits_read_signed(&stream, 16);
     }
-    case GAME_SCREEN: {
-        if (!any_brick_alive(&state)) {
-            state.screen_kind = GAME_OVER_SCREEN;
-            return;
-        }
-        if (any_brick_crossed_or_touched_paddle(&state)) {
-            state.screen_kind = GAME_OVER_SCREEN;
-            return;
-        }
 
-        // Button Actions
-        {
-            // Paddle Movements
-            if (gamepad & BUTTON_RIGHT) {
-                int next_paddle_x = clamp_int(state.paddle_x + 1,
-                                              MIN_PADDLE_X, MAX_PADDLE_X);
-                if (state.ball_velocity_y == 0 && next_paddle_x != state.paddle_x) {
-                    state.ball_x += 1;
-                }
-                state.paddle_x = next_paddle_x;
-            }
-            if (gamepad & BUTTON_LEFT) {
-                int next_paddle_x = clamp_int(state.paddle_x - 1,
-                                              MIN_PADDLE_X, MAX_PADDLE_X);
-                if (state.ball_velocity_y == 0 && next_paddle_x != state.paddle_x) {
-                    state.ball_x -= 1;
-                }
-                state.paddle_x = next_paddle_x;
-            }
-            if ((pressed_this_frame & BUTTON_2) && state.ball_velocity_y == 0) {
-                state.ball_velocity_y = BALL_VELOCITY_UP;
-            }
+    Brick_Field *bricks = &state->bricks;
+    bricks->num_alive = 0;
+    memset(bricks->alive_rows, 0, sizeof(bricks->alive_rows));
+    for (int i = 0; i < NUM_BRICKS; i++) {
+        uint8_t health = (uint8_t) bits_read(&stream, 4);
+        set_brick_health(bricks, i, health);
+        if (health > 0) {
+            bricks->alive_rows[i / NUM_BRICK_COLS] |= (Brick_Row_Mask) (1 << (i % NUM_BRICK_COLS));
+            bricks->num_alive++;
         }
+    }
+    for (int row = 0; row < NUM_BRICK_ROWS; row++) {
+        bricks->row_schedules[row].delay = (uint8_t) bits_read(&stream, 8);
+        bricks->row_schedules[row].shift = (uint8_t) bits_read(&stream, 3);
+    }
+    bricks->fall.clock.clock = (uint16_t) bits_read(&stream, 16);
+    bricks->fall.clock.clock_size = (uint16_t) bits_read(&stream, 16);
+    bricks->fall.clock.cycled = bits_read(&stream, 1);
+    bricks->fall.cycles = (uint16_t) bits_read(&stream, 16);
+    bricks->fall.acceleration = (uint16_t) bits_read(&stream, 16);
+    update_lowest_brick_bottom(bricks);
+    update_row_fall_range(bricks);
+
+    return !stream.overflowed;
+}
 
-        // Animate and State Update
-        {
-            Rect ball_bbox = {
-                .x=state.ball_x,
-                .y=state.ball_y,
-                .width=BALL_DIAMETER,
-                .height=BALL_DIAMETER,
-            };
-            Rect paddle_bbox = {
-                .x=state.paddle_x,
-                .y=PADDLE_Y,
-                .width=PADDLE_WIDTH,
-                .height=PADDLE_HEIGHT,
-            };
-            if (state.ball_y <= 0 && state.ball_velocity_y != 0) {
-                // Upper Wall
-                state.ball_velocity_y = BALL_VELOCITY_DOWN;
-            } else if (state.ball_y + BALL_DIAMETER >= SCREEN_SIZE - 1) {
-                // Lower Wall
-                if (state.num_balls_left > 0) {
-                    reset_ball(&state);
-                    state.num_balls_left--;
-                } else {
-                    state.screen_kind = GAME_OVER_SCREEN;
-                    return;
-                }
-            }
-            if (state.ball_x <= 0) {
-                // Left Wall
-                reflect_velocity_x_to_right(&state);
-            } else if (state.ball_x + BALL_DIAMETER >= SCREEN_SIZE) {
-                // Right Wall
-                reflect_velocity_x_to_left(&state);
-            }
+// Puts the game in the disk's save state (the disk is only written if
+// that changed), returns false if it doesn't fit in one
+bool save_to_disk() {
+    uint8_t save_state[SAVE_STATE_DISK_SIZE] = {0};
+    if (!save_game_state(&state, save_state)) {
+        return false;
+    }
+    if (memcmp(save_state, disk.image.save_state, sizeof(save_state)) != 0) {
+        memcpy(disk.image.save_state, save_state, sizeof(save_state));
+        disk.changed = true;
+    }
+    return true;
+}
 
-            if (state.ball_velocity_y != 0) {
-                bool colliding = false;
-                Direction dir;
-                if (bbox_colliding(ball_bbox, paddle_bbox, &dir)) {
-                    update_ball_velocity_based_on_direction(&state, dir);
-                    colliding = true;
-                }
-                if (colliding) {
-                    if ((gamepad & BUTTON_LEFT) && state.paddle_x > MIN_PADDLE_X) {
-                        update_ball_velocity_x_to_left(&state);
-                    }
-                    if ((gamepad & BUTTON_RIGHT) && state.paddle_x < MAX_PADDLE_X) {
-                        update_ball_velocity_x_to_right(&state);
-                    }
-                }
-            }
+// Saves at safe points: when the screen changes, when the ball is back
+// on the paddle and every SAVE_INTERVAL frames of play. The disk is
+// only written if the save state changed.
+void autosave(Screen_Kind previous_screen, bool ball_was_resting) {
+    disk.frames_since_save++;
+    bool playing = state.screen_kind == GAME_SCREEN;
+    if (state.screen_kind == previous_screen &&
+        !(playing && ball_resting(&state.balls) && !ball_was_resting) &&
+        !(playing && disk.frames_since_save >= SAVE_INTERVAL)) {
+        return;
+    }
+    disk.frames_since_save = 0;
+    save_to_disk();
+}
 
-            for (int i = 0; i < NUM_BRICKS; i++) {
-                if (state.bricks[i].health == 0) continue;
-                Rect brick_bbox = {
-                    .x=state.bricks[i].brick_x,
-                    .y=state.bricks[i].brick_y,
-                    .width=BRICK_WIDTH,
-                    .height=BRICK_HEIGHT,
-                };
-                bool colliding = false;
-                Direction dir;
-                if (bbox_colliding(ball_bbox, brick_bbox, &dir)) {
-                    update_ball_velocity_based_on_direction(&state, dir);
-                    colliding = true;
-                }
-                if (colliding) {
-                    state.bricks[i].health--;
-                    // 262 Hz - 523 Hz
-                    // 30 frames i.e; 0.5 sec
-                    // 100% volume
-                    // TONE_PULSE1
-                    // tone (262, 30, 100, TONE_PULSE1);
-                    // tone(262, 60, 100, TONE_PULSE1 | TONE_MODE3);
-                    tone(262 | (523 << 16), 5, 25, TONE_PULSE1 | TONE_MODE1);
-                    break;
-                }
-            }
+Rect paddle_rect(const Game_State *state, int player) {
+    Rect r = {
+        .x=player_paddle_x(state, player),
+        .y=PADDLE_Y,
+        .width=PADDLE_WIDTH,
+        .height=PADDLE_HEIGHT,
+    };
+    return r;
+}
 
-            state.ball_y = state.ball_y + state.ball_velocity_y;
+Rect lives_rect(uint8_t num_balls) {
+    Rect r = {
+        .x=LIVES_X,
+        .y=LIVES_Y,
+        .width=num_balls * (BALL_DIAMETER + 1),
+        .height=BALL_DIAMETER,
+    };
+    return r;
+}
 
-            switch (state.ball_velocity_x.kind) {
-            case BHV_L_L:
-                state.ball_x -= 1;
-                state.ball_velocity_x.mode = !state.ball_velocity_x.mode;
-                break;
-            case BHV_N_L:
-                if (state.ball_velocity_x.mode) {
-                    state.ball_x -= 1;
-                }
-                state.ball_velocity_x.mode = !state.ball_velocity_x.mode;
-                break;
-            case BHV_N_N:
-                state.ball_velocity_x.mode = !state.ball_velocity_x.mode;
-                break;
-            case BHV_N_R:
-                if (state.ball_velocity_x.mode) {
-                    state.ball_x += 1;
-                }
-                state.ball_velocity_x.mode = !state.ball_velocity_x.mode;
-                break;
-            case BHV_R_R:
-                state.ball_x += 1;
-                state.ball_velocity_x.mode = !state.ball_velocity_x.mode;
-                break;
-            default:
-                panicf("Invalid state.ball_velocity_x.kind: %d",
-                       state.ball_velocity_x.kind);
-            }
+#define MAX_BALL_CONTACTS 4
+#define NUM_WALLS         3
+
+// Around the play field, the bottom is open. The top is further up in
+// an arena.
+void play_field_walls(const Game_State *state, Rect walls[NUM_WALLS]) {
+    int top = state->arena ? arena_top(&state->arena_bricks) : 0;
+    Rect left = {-SCREEN_SIZE, top - SCREEN_SIZE, SCREEN_SIZE, 3 * SCREEN_SIZE - top};
+    Rect right = {SCREEN_SIZE, top - SCREEN_SIZE, SCREEN_SIZE, 3 * SCREEN_SIZE - top};
+    Rect ceiling = {-SCREEN_SIZE, top - SCREEN_SIZE, 3 * SCREEN_SIZE, SCREEN_SIZE};
+    walls[0] = left;
+    walls[1] = right;
+    walls[2] = ceiling;
+}
 
-            for (int i = 0; i < NUM_BRICKS; i++) {
-                if (state.bricks[i].health <= 0) {
-                    continue;
-                }
-                if (state.bricks[i].brick_fall_clock.clock == 0 &&
-                    state.bricks[i].brick_fall_clock.cycled) {
-                    state.bricks[i].brick_y++;
-                }
-                clock_tick(&state.bricks[i].brick_fall_clock);
+// Sends a ball that landed on the paddle back up. Where it landed
+// sets the angle (straight up in the middle, 45 degrees at the ends)
+// and moving the paddle puts some spin on it.
+void bounce_off_paddle(Game_State *state, int i, uint8_t gamepad) {
+    Ball_Pool *balls = &state->balls;
+    int paddle_x = player_paddle_x(state, ball_player(state, i));
+    Fixed speed = level_ball_speed(state);
+    Fixed offset = balls->x[i] + int_to_fixed(BALL_DIAMETER >> 1) -
+                   int_to_fixed(paddle_x + (PADDLE_WIDTH >> 1));
+    Fixed velocity_x = fixed_div(fixed_mul(offset, speed),
+                                 int_to_fixed((PADDLE_WIDTH + BALL_DIAMETER) >> 1));
+    if ((gamepad & BUTTON_LEFT) && paddle_x > MIN_PADDLE_X) {
+        velocity_x -= speed >> 1;
+    }
+    if ((gamepad & BUTTON_RIGHT) && paddle_x < MAX_PADDLE_X) {
+        velocity_x += speed >> 1;
+    }
+    balls->velocity_x[i] = (int16_t) clamp_int(velocity_x, -speed, speed);
+    balls->velocity_y[i] = (int16_t) -speed;
+}
+
+// Moves a ball through a frame. Everything it runs into on the way is
+// handled in the order it happens, so however fast the ball goes it
+// can't pass through a brick. gamepad is the ball's player's. Returns
+// true if it hit a brick.
+bool step_ball(Game_State *state, int i, uint8_t gamepad, Game_Events *events) {
+    Ball_Pool *balls = &state->balls;
+    Rect paddle = paddle_rect(state, ball_player(state, i));
+    Rect walls[NUM_WALLS];
+    play_field_walls(state, walls);
+    bool hit_brick = false;
+    Fixed remaining = FIXED_ONE;
+
+    for (int contact = 0; contact < MAX_BALL_CONTACTS; contact++) {
+        Fixed x = balls->x[i];
+        Fixed y = balls->y[i];
+        Fixed dx = fixed_mul(balls->velocity_x[i], remaining);
+        Fixed dy = fixed_mul(balls->velocity_y[i], remaining);
+
+        Sweep_Hit first = {0};
+        Sweep_Hit hit;
+        bool found = false;
+        bool on_paddle = false;
+        for (int w = 0; w < NUM_WALLS; w++) {
+            if (sweep_ball_rect(x, y, dx, dy, walls[w], &hit) &&
+                (!found || hit.time < first.time)) {
+                first = hit;
+                found = true;
             }
         }
+        if (sweep_ball_rect(x, y, dx, dy, paddle, &hit) &&
+            (!found || hit.time < first.time)) {
+            first = hit;
+            found = true;
+            on_paddle = true;
+        }
+        int brick = sweep_game_bricks(state, x, y, dx, dy, &hit);
+        if (brick >= 0 && (!found || hit.time < first.time)) {
+            first = hit;
+            found = true;
+            on_paddle = false;
+        } else {
+            brick = -1;
+        }
 
-        // Draw
-        {
-            *DRAW_COLORS = 0x43;
-            for (uint8_t i = 0; i < state.num_balls_left; i++) {
-                rect(1 + i * (BALL_DIAMETER + 1), 1, BALL_DIAMETER, BALL_DIAMETER);
-            }
-            rect(state.ball_x, state.ball_y, BALL_DIAMETER, BALL_DIAMETER);
+        if (!found) {
+            balls->x[i] = x + dx;
+            balls->y[i] = y + dy;
+            break;
+        }
 
-            *DRAW_COLORS = 0x41;
-            rect(state.paddle_x, PADDLE_Y, PADDLE_WIDTH, PADDLE_HEIGHT);
+        balls->x[i] = first.x;
+        balls->y[i] = first.y;
+        remaining -= fixed_mul(remaining, first.time);
+        if (on_paddle && first.normal_y < 0) {
+            bounce_off_paddle(state, i, gamepad);
+        } else {
+            reflect_ball(balls, i, &first);
+        }
 
-            for (int i = 0; i < NUM_BRICKS; i++) {
-                if (state.bricks[i].health <= 0) {
-                    continue;
-                }
-                *DRAW_COLORS = 0x03;
-                rect(state.bricks[i].brick_x,
-                     state.bricks[i].brick_y,
-                     BRICK_WIDTH,
-                     BRICK_HEIGHT);
-                *DRAW_COLORS = 0x04;
-                for (int j = 0; j < state.bricks[i].health; j++) {
-                    vline(state.bricks[i].brick_x + j,
-                          state.bricks[i].brick_y,
-                          BRICK_HEIGHT);
+        if (brick >= 0) {
+            Rect r = game_brick_rect(state, brick);
+            mark_dirty(events, r);
+            bool broken = damage_game_brick(state, brick);
+            if (broken) {
+                note_broken_brick(events, r);
+            }
+            if (broken && state->versus) {
+                state->bricks_broken[i]++;
+            } else if (broken && state->game_mode == MULTI_BALL_MODE) {
+                Fixed speed = level_ball_speed(state);
+                int ball = spawn_ball(
+                    balls,
+                    r.x + (r.width >> 1) - (BALL_DIAMETER >> 1),
+                    r.y + ((r.height - BALL_DIAMETER) >> 1),
+                    (brick % 5 - 2) * (speed >> 1),
+                    speed);
+                if (ball >= 0) {
+                    mark_dirty(events, ball_rect(balls, ball));
                 }
             }
+            hit_brick = true;
         }
-        break;
     }
-    case GAME_OVER_SCREEN: {
-        int text_x = 5;
-        int text_y = 5;
-        int text_ypad = 3;
+    return hit_brick;
+}
 
-        {
-            int count = count_alive_bricks(&state);
-            if (count > 0) {
-                {
-                    *DRAW_COLORS = 0x04;
-                    text("Game Over :(", text_x, text_y);
-
-                    text_y += FONT_SIZE + text_ypad;
-                    text("You have destroyed", text_x, text_y);
-
-                    itoa(NUM_BRICKS - count, temp_buffer, 10);
-                    text_y += FONT_SIZE + text_ypad;
-                    text(temp_buffer, text_x, text_y);
-                    text("bricks",
-                         text_x + (FONT_SIZE * (1 + (int) strlen(temp_buffer))),
-                         text_y);
-                }
+// Clears the background with a particular
+// color from the current set palette
+// color_index are values from 1-4
+// corresponding to 4 colors in the palette
+void clear_background() {
+    int palette_color = *DRAW_COLORS & 0b1111;
+    raster_clear((uint8_t) ((palette_color - 1) & 0b11));
+}
 
-                text_y += FONT_SIZE + text_ypad;
-                text_y += FONT_SIZE + text_ypad;
+// Fills the part of r inside clip with a single palette color (1-4)
+void fill_rect_clipped(Rect r, uint16_t color, Render_Layer layer, Rect clip) {
+    Rect visible = rect_intersection(r, clip);
+    if (rect_empty(visible)) {
+        return;
+    }
+    render_rect(&renderer.commands, layer, color, visible);
+}
 
-                {
-                    *DRAW_COLORS = 0x01;
-                    text("Press up arrow to", text_x, text_y);
+// Same as rect() with the given draw colors, but without touching
+// any pixel outside of clip. A stroked rect is drawn as the stroke
+// color filling r, then the fill color filling the inside of it.
+void draw_rect_clipped(Rect r, uint16_t draw_colors, Rect clip) {
+    if (rect_empty(rect_intersection(r, clip))) {
+        return;
+    }
+    if (rect_contains(clip, r)) {
+        render_rect(&renderer.commands, RENDER_LAYER_SHAPES, draw_colors, r);
+        return;
+    }
 
-                    text_y += FONT_SIZE + text_ypad;
-                    text("retry!", text_x, text_y);
-                }
-            } else {
-                {
-                    *DRAW_COLORS = 0x04;
-                    text("Congratulations!", text_x, text_y);
+    uint16_t fill = draw_colors & 0xf;
+    uint16_t stroke = (draw_colors >> 4) & 0xf;
+    Rect inner = {r.x + 1, r.y + 1, r.width - 2, r.height - 2};
+    if (stroke == 0) {
+        if (fill != 0) {
+            fill_rect_clipped(r, fill, RENDER_LAYER_SHAPES, clip);
+        }
+    } else if (fill != 0) {
+        fill_rect_clipped(r, stroke, RENDER_LAYER_SHAPES, clip);
+        fill_rect_clipped(inner, fill, RENDER_LAYER_SHAPE_FILLS, clip);
+    } else {
+        fill_rect_clipped((Rect) {r.x, r.y, r.width, 1}, stroke, RENDER_LAYER_SHAPES, clip);
+        fill_rect_clipped((Rect) {r.x, r.y + r.height - 1, r.width, 1}, stroke,
+                          RENDER_LAYER_SHAPES, clip);
+        fill_rect_clipped((Rect) {r.x, r.y, 1, r.height}, stroke, RENDER_LAYER_SHAPES, clip);
+        fill_rect_clipped((Rect) {r.x + r.width - 1, r.y, 1, r.height}, stroke,
+                          RENDER_LAYER_SHAPES, clip);
+    }
+}
+
+// Draws the part of a sprite placed at r that is inside clip,
+// (src_x, src_y) is where r starts in the sprite
+void draw_sprite_clipped(const uint8_t *sprite, int stride, int src_x, int src_y,
+                         Rect r, Rect clip) {
+    Rect visible = rect_intersection(r, clip);
+    if (rect_empty(visible)) {
+        return;
+    }
+    render_blit(&renderer.commands, RENDER_LAYER_SPRITES, SPRITE_DRAW_COLORS, sprite, visible,
+                src_x + visible.x - r.x, src_y + visible.y - r.y, stride, SPRITE_FLAGS);
+}
 
-                    text_y += FONT_SIZE + text_ypad;
-                    text("You have destroyed", text_x, text_y);
+// The game is simulated in world coordinates, which are the screen's
+// but in an arena, where the view scrolls to follow the ball. The HUD
+// (the lives) stays put on the screen.
+Rect world_to_screen(Rect r) {
+    r.y -= renderer.events.view_y;
+    return r;
+}
+
+Rect screen_to_world(Rect r) {
+    r.y += renderer.events.view_y;
+    return r;
+}
+
+// How far below the top of the view the lowest ball is kept
+#define CAMERA_BALL_Y 64
+
+// Top of the view: as much of the arena above the lowest ball as there
+// is room for, with the paddle in view whenever that ball is low enough
+int game_camera_y(const Game_State *state) {
+    if (!state->arena) {
+        return 0;
+    }
+    const Ball_Pool *balls = &state->balls;
+    int lowest = PADDLE_Y;
+    for (int i = 0; i < balls->count; i++) {
+        int y = fixed_floor(balls->y[i]);
+        if (i == 0 || y > lowest) {
+            lowest = y;
+        }
+    }
+    return clamp_int(lowest - CAMERA_BALL_Y, arena_top(&state->arena_bricks), 0);
+}
+
+// The brick's cell in the atlas, its transparent padding included so
+// the bricks next to it merge into the same blit
+void draw_brick(int i, Rect clip) {
+    Rect r = world_to_screen(brick_rect(&state.bricks, i));
+    r.width = BRICK_WIDTH_PLUS_PADDING;
+    draw_sprite_clipped(brick_atlas, BRICK_ATLAS_WIDTH, r.x,
+                        (brick_health(&state.bricks, i) - 1) * (BRICK_HEIGHT),
+                        r, clip);
+}
+
+void draw_arena_brick(int i, Rect clip) {
+    Rect r = world_to_screen(arena_brick_rect(&state.arena_bricks, i));
+    r.width = BRICK_WIDTH_PLUS_PADDING;
+    draw_sprite_clipped(brick_atlas, BRICK_ATLAS_WIDTH, r.x,
+                        (arena_brick_health(&state.arena_bricks, i) - 1) * (BRICK_HEIGHT),
+                        r, clip);
+}
+
+// Only the rows of the arena that are in clip are looked at, so
+// drawing it costs the same however big it is
+void draw_arena_bricks(Rect clip) {
+    const Brick_Arena *arena = &state.arena_bricks;
+    int first, last;
+    if (!arena_rows_between(arena, screen_to_world(clip).y, clip.height, &first, &last)) {
+        return;
+    }
+    for (int row = first; row <= last; row++) {
+        for (Brick_Row_Mask mask = arena->alive_rows[row]; mask; mask &= mask - 1) {
+            draw_arena_brick(row * NUM_BRICK_COLS + __builtin_ctz(mask), clip);
+        }
+    }
+}
+
+void draw_lives(Rect clip) {
+    for (uint8_t i = 0; i < state.num_balls_left; i++) {
+        // With the gap after it, so the lives merge into one blit
+        Rect life = {LIVES_X + i * (BALL_DIAMETER + 1), LIVES_Y, BALL_DIAMETER + 1, BALL_DIAMETER};
+        draw_sprite_clipped(ball_strip, BALL_STRIP_WIDTH,
+                            LIVES_X + (i % NUM_BALL_STRIP_CELLS) * (BALL_DIAMETER + 1), 0,
+                            life, clip);
+    }
+}
 
-                    text_y += FONT_SIZE + text_ypad;
-                    text("All the bricks!", text_x, text_y);
+// Draws everything on GAME_SCREEN that overlaps clip (in screen
+// coordinates), in back to front order, without touching any pixel
+// outside of clip
+void draw_game_screen(Rect clip) {
+    // Bricks scroll under the lives in an arena, they go on top there
+    if (!state.arena) {
+        draw_lives(clip);
+    }
+    for (int i = 0; i < state.balls.count; i++) {
+        draw_sprite_clipped(ball_strip, BALL_STRIP_WIDTH, LIVES_X, 0,
+                            world_to_screen(ball_rect(&state.balls, i)), clip);
+    }
+    draw_rect_clipped(world_to_screen(paddle_rect(&state, 0)), 0x41, clip);
+    if (state.versus) {
+        draw_rect_clipped(world_to_screen(paddle_rect(&state, 1)), 0x43, clip);
+    }
+    if (state.arena) {
+        draw_arena_bricks(clip);
+        draw_lives(clip);
+        return;
+    }
+    for (int row = 0; row < NUM_BRICK_ROWS; row++) {
+        for (Brick_Row_Mask mask = state.bricks.alive_rows[row]; mask; mask &= mask - 1) {
+            draw_brick(row * NUM_BRICK_COLS + __builtin_ctz(mask), clip);
+        }
+    }
+}
+
+// Repaints GAME_SCREEN, either completely (as when the view scrolled)
+// or only the regions that were marked dirty since the last frame
+void render_game_screen() {
+    Rect screen = {0, 0, SCREEN_SIZE, SCREEN_SIZE};
+    int camera_y = game_camera_y(&state);
+    bool scrolled = camera_y != renderer.events.view_y;
+    if (scrolled) {
+        scroll_particles(&particles, renderer.events.view_y - camera_y);
+    }
+    renderer.events.view_y = camera_y;
+
+    if (!renderer.events.full_repaint && renderer.screen_kind == GAME_SCREEN) {
+        if (state.paddle_x != renderer.paddle_x) {
+            Rect paddle = paddle_rect(&state, 0);
+            paddle.x = renderer.paddle_x;
+            mark_dirty(&renderer.events, rect_union(paddle, paddle_rect(&state, 0)));
+        }
+        if (state.versus && state.paddle2_x != renderer.paddle2_x) {
+            Rect paddle = paddle_rect(&state, 1);
+            paddle.x = renderer.paddle2_x;
+            mark_dirty(&renderer.events, rect_union(paddle, paddle_rect(&state, 1)));
+        }
+        if (state.num_balls_left != renderer.num_balls_left) {
+            dirty_add(&renderer.events.dirty, rect_union(lives_rect(state.num_balls_left),
+                                                  lives_rect(renderer.num_balls_left)));
+        }
+        // The particles are drawn again wherever they are now
+        if (!rect_empty(particles.drawn)) {
+            dirty_add(&renderer.events.dirty, particles.drawn);
+        }
+    }
+
+    const Dirty_Rects *dirty = &renderer.events.dirty;
+    if (renderer.events.full_repaint || renderer.screen_kind != GAME_SCREEN ||
+        dirty->overflowed || scrolled) {
+        *DRAW_COLORS = 0x02;
+        clear_background();
+        draw_game_screen(screen);
+    } else {
+        for (uint8_t i = 0; i < dirty->count; i++) {
+            fill_rect_clipped(dirty->rects[i], 0x02, RENDER_LAYER_BACKGROUND, screen);
+            draw_game_screen(dirty->rects[i]);
+        }
+    }
+
+    renderer.paddle_x = state.paddle_x;
+    renderer.paddle2_x = state.paddle2_x;
+    renderer.num_balls_left = state.num_balls_left;
+}
+
+static const Text_Line help_text[] = {
+    TEXT_LINE(0,  0x04, "Welcome to the"),
+    TEXT_LINE(1,  0x04, "Brick Breaker!"),
+    TEXT_LINE(3,  0x03, "Click on x"),
+    TEXT_LINE(4,  0x03, "to switch the color"),
+    TEXT_LINE(5,  0x03, "palette."),
+    TEXT_LINE(7,  0x01, "Press up arrow to"),
+    TEXT_LINE(8,  0x01, "start the game!"),
+    TEXT_LINE(9,  0x03, "Press down arrow"),
+    TEXT_LINE(10, 0x03, "in game to open"),
+    TEXT_LINE(11, 0x03, "this help"),
+};
+
+static const Text_Line game_mode_text[NUM_GAME_MODES] = {
+    [SINGLE_BALL_MODE] = TEXT_LINE(12, 0x03, "Multi-ball (z): OFF"),
+    [MULTI_BALL_MODE]  = TEXT_LINE(12, 0x03, "Multi-ball (z): ON"),
+};
+
+static const Text_Line endless_text[] = {
+    [false] = TEXT_LINE(13, 0x03, "Endless (>): OFF"),
+    [true]  = TEXT_LINE(13, 0x03, "Endless (>): ON"),
+};
+
+static const Text_Line arena_text[] = {
+    [false] = TEXT_LINE(2, 0x03, "Arena (v+^): OFF"),
+    [true]  = TEXT_LINE(2, 0x03, "Arena (v+^): ON"),
+};
+
+static const Text_Line versus_text[] = {
+    [false] = TEXT_LINE(6, 0x03, "Versus (P2 z): OFF"),
+    [true]  = TEXT_LINE(6, 0x03, "Versus (P2 z): ON"),
+};
+
+// Line 2 is the number of bricks destroyed
+#define BRICKS_DESTROYED_LINE 2
+
+static const Text_Line game_over_text[] = {
+    TEXT_LINE(0, 0x04, "Game Over :("),
+    TEXT_LINE(1, 0x04, "You have destroyed"),
+    TEXT_LINE(4, 0x01, "Press up arrow to"),
+    TEXT_LINE(5, 0x01, "retry!"),
+};
+
+static const Text_Line level_cleared_text[] = {
+    TEXT_LINE(0, 0x04, "Congratulations!"),
+    TEXT_LINE(1, 0x04, "You have destroyed"),
+    TEXT_LINE(2, 0x04, "All the bricks!"),
+    TEXT_LINE(4, 0x01, "Press up arrow to"),
+};
+
+static const Text_Line next_level_text[] = {
+    TEXT_LINE(5, 0x01, "next level!"),
+};
+
+static const Text_Line last_level_cleared_text[] = {
+    TEXT_LINE(5, 0x01, "restart from"),
+    TEXT_LINE(6, 0x01, "the beginning!"),
+};
+
+// HELP_SCREEN and GAME_OVER_SCREEN never change while they are shown,
+// so they are drawn once when entered (or when the palette or what
+// they show changes) and stay in the preserved framebuffer
+bool static_screen_stale() {
+    return renderer.events.full_repaint || renderer.screen_kind != state.screen_kind;
+}
+
+void render_help_screen() {
+    if (!static_screen_stale()) {
+        return;
+    }
+    *DRAW_COLORS = 0x02;
+    clear_background();
+    draw_text_lines(help_text, ARRAY_LEN(help_text));
+    draw_text_lines(&game_mode_text[state.game_mode], 1);
+    draw_text_lines(&endless_text[state.endless], 1);
+    draw_text_lines(&versus_text[state.versus], 1);
+    draw_text_lines(&arena_text[state.arena], 1);
+}
+
+static const Text_Line versus_result_text[] = {
+    TEXT_LINE(5, 0x01, "Press up arrow to"),
+    TEXT_LINE(6, 0x01, "play again!"),
+};
+
+static const Text_Line versus_winner_text[] = {
+    TEXT_LINE(0, 0x04, "It's a draw!"),
+    TEXT_LINE(0, 0x04, "Player 1 wins!"),
+    TEXT_LINE(0, 0x04, "Player 2 wins!"),
+};
+
+// Who won and the bricks each player broke
+void render_versus_result() {
+    int winner = 0;
+    if (state.bricks_broken[0] != state.bricks_broken[1]) {
+        winner = state.bricks_broken[0] > state.bricks_broken[1] ? 1 : 2;
+    }
+    draw_text_lines(&versus_winner_text[winner], 1);
+    draw_text_lines(versus_result_text, ARRAY_LEN(versus_result_text));
+    for (int player = 0; player < NUM_PLAYERS; player++) {
+        char label[] = "Player 1:";
+        char broken[12];
+        int y = TEXT_LINE_Y(2 + player);
+        label[7] = (char) ('1' + player);
+        itoa(state.bricks_broken[player], broken, 10);
+        *DRAW_COLORS = 0x04;
+        text(label, TEXT_X, y);
+        PERF_COUNT(PERF_TEXTS);
+        text(broken, TEXT_X + FONT_SIZE * (int) sizeof(label), y);
+        PERF_COUNT(PERF_TEXTS);
+    }
+}
+
+void render_game_over_screen() {
+    if (!static_screen_stale()) {
+        return;
+    }
+    *DRAW_COLORS = 0x02;
+    clear_background();
+    if (state.versus) {
+        render_versus_result();
+        return;
+    }
+
+    int count = count_alive_bricks(&state);
+    if (count > 0) {
+        char destroyed[12];
+        draw_text_lines(game_over_text, ARRAY_LEN(game_over_text));
+        itoa(count_bricks(&state) - count, destroyed, 10);
+        *DRAW_COLORS = 0x04;
+        text(destroyed, TEXT_X, TEXT_LINE_Y(BRICKS_DESTROYED_LINE));
+        PERF_COUNT(PERF_TEXTS);
+        text("bricks", TEXT_X + (FONT_SIZE * (1 + (int) strlen(destroyed))),
+             TEXT_LINE_Y(BRICKS_DESTROYED_LINE));
+        PERF_COUNT(PERF_TEXTS);
+    } else {
+        draw_text_lines(level_cleared_text, ARRAY_LEN(level_cleared_text));
+        if (next_level(&state) != FIRST_LEVEL) {
+            draw_text_lines(next_level_text, ARRAY_LEN(next_level_text));
+        } else {
+            draw_text_lines(last_level_cleared_text, ARRAY_LEN(last_level_cleared_text));
+        }
+    }
+}
+
+// The column with the least health left (the one nearest to x on
+// ties), or -1 if none has any
+int weakest_column(const int *column_health, int x) {
+    int target = -1;
+    int target_distance = 0;
+    for (int col = 0; col < NUM_BRICK_COLS; col++) {
+        if (column_health[col] == 0) {
+            continue;
+        }
+        int distance = abs_int(brick_col_x(col) + ((BRICK_WIDTH) >> 1) - x);
+        int target_health = target >= 0 ? column_health[target] : 0;
+        if (target < 0 || column_health[col] < target_health ||
+            (column_health[col] == target_health && distance < target_distance)) {
+            target = col;
+            target_distance = distance;
+        }
+    }
+    return target;
+}
+
+// The lowest alive brick of the weakest column, or -1 once there are
+// none. Breaking through there gets the ball above the bricks soonest.
+int autoplayer_target(const Brick_Field *bricks, int x) {
+    int column_health[NUM_BRICK_COLS] = {0};
+    int lowest[NUM_BRICK_COLS];
+    for (int i = 0; i < NUM_BRICKS; i++) {
+        int health = brick_health(bricks, i);
+        column_health[i % NUM_BRICK_COLS] += health;
+        if (health > 0) {
+            lowest[i % NUM_BRICK_COLS] = i;
+        }
+    }
+    int col = weakest_column(column_health, x);
+    return col >= 0 ? lowest[col] : -1;
+}
+
+// Same, over the band of rows the lowest bricks of an arena are in
+int autoplayer_arena_target(const Brick_Arena *arena, int x) {
+    int last_row = arena_lowest_row(arena);
+    if (last_row < 0) {
+        return -1;
+    }
+    int column_health[NUM_BRICK_COLS] = {0};
+    int lowest[NUM_BRICK_COLS];
+    for (int i = last_row / ARENA_BAND_ROWS * ARENA_BAND_ROWS * NUM_BRICK_COLS;
+         i < (last_row + 1) * NUM_BRICK_COLS; i++) {
+        int health = arena_brick_health(arena, i);
+        column_health[i % NUM_BRICK_COLS] += health;
+        if (health > 0) {
+            lowest[i % NUM_BRICK_COLS] = i;
+        }
+    }
+    int col = weakest_column(column_health, x);
+    return col >= 0 ? lowest[col] : -1;
+}
+
+// Frames of flight the autoplayer looks ahead at most
+#define AUTOPLAYER_LOOKAHEAD 400
+
+// Follows ball i frame by frame off the walls and the bricks as they are
+// (bricks it would break included) until it gets down to the paddle,
+// *landing_x is where its left edge is then. Right in more cases than
+// predict_ball_landing() but more work, so only for a single ball.
+// Returns how many frames that takes, or -1 for more than
+// AUTOPLAYER_LOOKAHEAD.
+int32_t follow_ball_landing(const Game_State *state, int i, Fixed *landing_x) {
+    const Ball_Pool *balls = &state->balls;
+    Fixed x = balls->x[i];
+    Fixed y = balls->y[i];
+    Fixed velocity_x = balls->velocity_x[i];
+    Fixed velocity_y = balls->velocity_y[i];
+    Fixed landing_y = int_to_fixed(PADDLE_Y - BALL_DIAMETER);
+    Rect walls[NUM_WALLS];
+    play_field_walls(state, walls);
+
+    for (int32_t frame = 0; frame < AUTOPLAYER_LOOKAHEAD; frame++) {
+        if (velocity_y > 0 && y >= landing_y) {
+            *landing_x = x;
+            return frame;
+        }
+        Fixed remaining = FIXED_ONE;
+        for (int contact = 0; contact < MAX_BALL_CONTACTS; contact++) {
+            Fixed dx = fixed_mul(velocity_x, remaining);
+            Fixed dy = fixed_mul(velocity_y, remaining);
+            Sweep_Hit first = {0};
+            Sweep_Hit hit;
+            bool found = false;
+            for (int w = 0; w < NUM_WALLS; w++) {
+                if (sweep_ball_rect(x, y, dx, dy, walls[w], &hit) &&
+                    (!found || hit.time < first.time)) {
+                    first = hit;
+                    found = true;
                 }
+            }
+            if (sweep_game_bricks(state, x, y, dx, dy, &hit) >= 0 &&
+                (!found || hit.time < first.time)) {
+                first = hit;
+                found = true;
+            }
+            if (!found) {
+                x += dx;
+                y += dy;
+                break;
+            }
+            x = first.x;
+            y = first.y;
+            remaining -= fixed_mul(remaining, first.time);
+            if (first.normal_x != 0) {
+                velocity_x = abs_int(velocity_x) * first.normal_x;
+            }
+            if (first.normal_y != 0) {
+                velocity_y = abs_int(velocity_y) * first.normal_y;
+            }
+        }
+    }
+    return -1;
+}
+
+// The buttons of a player, player 2 (versus) only joins on the help
+// screen and plays their own ball
+uint8_t autoplayer_player_input(const Game_State *state, int player) {
+    uint8_t previous_gamepad = player == 0 ? state->previous_gamepad : state->previous_gamepad2;
+    if (state->screen_kind != GAME_SCREEN) {
+        if (player == 0) {
+            return previous_gamepad & BUTTON_UP ? 0 : BUTTON_UP;
+        }
+        bool join = state->screen_kind == HELP_SCREEN && !state->versus;
+        return join && !(previous_gamepad & BUTTON_2) ? BUTTON_2 : 0;
+    }
+    const Ball_Pool *balls = &state->balls;
+    if (player_ball_resting(state, player)) {
+        return previous_gamepad & BUTTON_2 ? 0 : BUTTON_2;
+    }
+    int paddle_x = player_paddle_x(state, player);
+
+    // The ball that comes down first, by a quick guess, then followed
+    // through the bricks
+    int ball = -1;
+    int32_t soonest = -1;
+    Fixed landing_x = 0;
+    for (int i = 0; i < balls->count; i++) {
+        if (ball_player(state, i) != player) {
+            continue;
+        }
+        Fixed x;
+        int32_t frames = predict_ball_landing(balls, i, PADDLE_Y - BALL_DIAMETER,
+                                              SCREEN_SIZE - BALL_DIAMETER, &x);
+        if (frames >= 0 && (soonest < 0 || frames < soonest)) {
+            ball = i;
+            soonest = frames;
+            landing_x = x;
+        }
+    }
+    if (ball < 0) {
+        return 0;
+    }
+    Fixed followed_x;
+    int32_t followed = follow_ball_landing(state, ball, &followed_x);
+    if (followed >= 0) {
+        soonest = followed;
+        landing_x = followed_x;
+    }
+
+    // bounce_off_paddle() sends the ball off sideways at speed * offset
+    // / ((PADDLE_WIDTH + BALL_DIAMETER) / 2) for the same vertical speed,
+    // offset being how far off the paddle's center it lands
+    int ball_center = fixed_floor(landing_x) + (BALL_DIAMETER >> 1);
+    int offset = 0;
+    int target = state->arena ? autoplayer_arena_target(&state->arena_bricks, ball_center) :
+                                autoplayer_target(&state->bricks, ball_center);
+    if (target >= 0) {
+        Rect r = game_brick_rect(state, target);
+        int rise = PADDLE_Y - (r.y + r.height);
+        if (rise > 0) {
+            offset = (r.x + (r.width >> 1) - ball_center) *
+                     ((PADDLE_WIDTH + BALL_DIAMETER) >> 1) / rise;
+        }
+    }
+    int max_offset = (PADDLE_WIDTH >> 1) - 2;
+    offset = clamp_int(offset, -max_offset, max_offset);
+    int target_x = clamp_int(ball_center - offset - (PADDLE_WIDTH >> 1),
+                             MIN_PADDLE_X, MAX_PADDLE_X);
+    // Against a wall the paddle can't get to that side of the ball: off
+    // the other side of it then, so it doesn't go straight up and down
+    // forever
+    int reached = ball_center - (target_x + (PADDLE_WIDTH >> 1));
+    if (abs_int(offset) >= 2 && abs_int(reached) < 2) {
+        target_x = clamp_int(ball_center + offset - (PADDLE_WIDTH >> 1),
+                             MIN_PADDLE_X, MAX_PADDLE_X);
+    }
+    // The paddle moves a pixel per frame, the ball can be faster: without
+    // the time to aim, the least move that still catches it
+    if (abs_int(target_x - paddle_x) + 2 >= soonest) {
+        target_x = clamp_int(paddle_x, ball_center + 4 - PADDLE_WIDTH, ball_center - 4);
+    }
+
+    if (target_x < paddle_x) {
+        return BUTTON_LEFT;
+    }
+    if (target_x > paddle_x) {
+        return BUTTON_RIGHT;
+    }
+    return 0;
+}
+
+// Autoplayer: GAMEPAD1 (or GAMEPAD2 in versus) as a player would press
+// it, worked out from nothing but the game state (so it plays the same
+// way every time). It keeps the paddle under where the next ball comes
+// down, hitting it off center to send it towards the bricks, launches
+// the ball and presses up on the other screens. Plays the attract mode
+// demo and drives the native soak test.
+uint8_t autoplayer_input(const Game_State *state) {
+    return autoplayer_player_input(state, 0);
+}
+
+// Puts the cart's game where a session starts and starts recording it
+void reset_game(Level level, Palette_Picker palette, Game_Mode game_mode, uint32_t seed,
+                int arena_num_bricks) {
+    game_reset(&state, level, palette, game_mode, seed, arena_num_bricks);
+    set_palette(state.current_palette);
+    renderer.events.full_repaint = true;
+
+    replay_begin(replays.recording, (uint8_t) level, (uint8_t) palette, (uint8_t) game_mode,
+                 seed, state.arena_num_bricks);
+    replays.recording_on = true;
+    replays.recording_full = false;
+}
+
+// Picks up where the disk's save state left off, on the help screen.
+// Returns false if it isn't valid.
+bool resume_saved_game() {
+    if (!load_game_state(&state, disk.image.save_state)) {
+        return false;
+    }
+    // So the game doesn't go on before the player is ready
+    if (state.screen_kind == GAME_SCREEN) {
+        state.screen_kind = HELP_SCREEN;
+    }
+    // A generated level is generated here rather than in the middle
+    // of play, when the ball first needs its speed
+    uint32_t level_size;
+    level_data(&state, &level_size);
+    set_palette(state.current_palette);
+    renderer.events.full_repaint = true;
+    replays.recording_on = false;
+    return true;
+}
+
+void load_disk() {
+    uint32_t size = diskr(&disk.image, sizeof(disk.image));
+    memset((uint8_t *) &disk.image + size, 0, sizeof(disk.image) - size);
+    if (!resume_saved_game()) {
+        reset_game(FIRST_LEVEL, ICE_CREAM_GB, SINGLE_BALL_MODE, endless_seed, arena_num_bricks);
+    }
+}
+
+void start() {
+    stack_paint();
+    *SYSTEM_FLAGS = SYSTEM_PRESERVE_FRAMEBUFFER;
+    reset_game(FIRST_LEVEL, ICE_CREAM_GB, SINGLE_BALL_MODE, endless_seed, arena_num_bricks);
+    load_disk();
+    particles_init(&particles, particle_storage, PARTICLE_CAPACITY);
+}
+
+// Called once the last frame of the replay was played
+void finish_replay() {
+    uint32_t checksum = game_state_checksum(&state);
+    replays.playing = false;
+    if (checksum == replays.player.header->checksum) {
+        replays.result = REPLAY_MATCHED;
+    } else {
+        replays.result = REPLAY_DIVERGED;
+        tracef("Replay diverged: checksum %x, expected %x",
+               checksum, replays.player.header->checksum);
+    }
+    if (replays.resume_save) {
+        replays.resume_save = false;
+        if (!resume_saved_game()) {
+            panic("Unreachable! The replay lost the game");
+        }
+    }
+}
+
+// Restarts the session from where the replay started and feeds it
+// the replay's buttons instead of GAMEPAD1 until it runs out. The
+// replay must stay around (and be valid) until then.
+void start_replay(const Replay_Header *header, const Replay_Run *runs) {
+    reset_game((Level) (header->level % NUM_LEVELS),
+               (Palette_Picker) (header->palette % NUM_PALETTE_PICKER),
+               (Game_Mode) (header->game_mode % NUM_GAME_MODES), header->endless_seed,
+               clamp_int(header->arena_num_bricks, 1, ARENA_MAX_BRICKS));
+    replay_play(&replays.player, header, runs);
+    replays.playing = true;
+    replays.result = REPLAY_NONE;
+    if (header->num_runs == 0) {
+        finish_replay();
+    }
+}
+
+// Plays back the replay on the disk, if there is one. The game in
+// progress is saved first (nothing is saved during a replay) and picked
+// up again from the save once the replay is over, games that don't fit
+// in a save state whole keep the help screen.
+void play_disk_replay() {
+    if (!replay_valid(&disk.image.replay.header, REPLAY_DISK_SIZE)) {
+        trace("No replay on the disk");
+        return;
+    }
+    if (!game_fits_save_state(&state) || !save_to_disk()) {
+        trace("The game in progress doesn't fit in a save state");
+        return;
+    }
+    replays.resume_save = true;
+    start_replay(&disk.image.replay.header, disk.image.replay.runs);
+}
+
+// Ends the recording here (unless it already ended) so it can be
+// saved, it goes on if more frames are played
+void seal_recording() {
+    if (!replays.recording_full) {
+        replays.recording->checksum = game_state_checksum(&state);
+    }
+}
 
-                text_y += FONT_SIZE + text_ypad;
-                text_y += FONT_SIZE + text_ypad;
+void save_recording() {
+    if (!replays.recording_on) {
+        return;
+    }
+    seal_recording();
+    uint32_t size = (uint32_t) (sizeof(Replay_Header) +
+                                replays.recording->num_runs * sizeof(Replay_Run));
+    // Only a bigger buffer from a native tool can hold more
+    if (size <= sizeof(disk.image.replay)) {
+        memcpy(&disk.image.replay, replays.recording, size);
+        disk.changed = true;
+    }
+}
+
+// *DRAW_COLORS = 0xABCD;
+// D: Fill Color (0 - 5)
+// C: Stroke Color (0 - 5)&
+// A and B currently unknown
+// ---
+// 0: TRANSPARENT
+// 1: PALETTE[0] i.e; Color 1
+// 2: PALETTE[1] i.e; Color 2
+// 3: PALETTE[2] i.e; Color 3
+// 4: PALETTE[3] i.e; Color 4
+
+// Moves the player's paddle a pixel (their ball with it while it rests
+// on it) and launches their ball
+void control_paddle(Game_State *state, int player, uint8_t gamepad, uint8_t pressed,
+                    Game_Events *events) {
+    Ball_Pool *balls = &state->balls;
+    int *paddle_x = player == 0 ? &state->paddle_x : &state->paddle2_x;
+    int ball = state->versus ? player : 0;
+    if (gamepad & BUTTON_RIGHT) {
+        int next_paddle_x = clamp_int(*paddle_x + 1, MIN_PADDLE_X, MAX_PADDLE_X);
+        if (player_ball_resting(state, player) && next_paddle_x != *paddle_x) {
+            mark_dirty(events, ball_rect(balls, ball));
+            balls->x[ball] += FIXED_ONE;
+        }
+        *paddle_x = next_paddle_x;
+    }
+    if (gamepad & BUTTON_LEFT) {
+        int next_paddle_x = clamp_int(*paddle_x - 1, MIN_PADDLE_X, MAX_PADDLE_X);
+        if (player_ball_resting(state, player) && next_paddle_x != *paddle_x) {
+            mark_dirty(events, ball_rect(balls, ball));
+            balls->x[ball] -= FIXED_ONE;
+        }
+        *paddle_x = next_paddle_x;
+    }
+    if ((pressed & BUTTON_2) && player_ball_resting(state, player)) {
+        balls->velocity_y[ball] = (int16_t) -level_ball_speed(state);
+    }
+}
 
-                {
-                    *DRAW_COLORS = 0x01;
-                    text("Press up arrow to", text_x, text_y);
+// Advances the game by a frame of input, gamepad2 is player 2's (only
+// read on the help screen and in versus). Everything it touches is in
+// state (and in events, if given), so any number of games can be
+// stepped side by side. Returns false for the frames that only switch
+// screens, there's nothing new to draw then.
+bool game_step(Game_State *state, uint8_t gamepad, uint8_t gamepad2, Game_Events *events) {
+    uint8_t pressed_this_frame = gamepad & (gamepad ^ state->previous_gamepad);
+    uint8_t pressed2 = gamepad2 & (gamepad2 ^ state->previous_gamepad2);
 
-                    if (state.level + 1 < NUM_LEVELS) {
-                        text_y += FONT_SIZE + text_ypad;
-                        text("next level!", text_x, text_y);
+    // Palette Switch
+    if (pressed_this_frame & BUTTON_1) {
+        state->current_palette = (state->current_palette + 1) % NUM_PALETTE_PICKER;
+        mark_all_dirty(events);
+    }
+
+    // Player 2 joins (or leaves) on the help screen, for a new single
+    // ball game (not while one is in progress)
+    if (state->screen_kind == HELP_SCREEN && (pressed2 & BUTTON_2) && !state->in_progress) {
+        state->versus = !state->versus;
+        state->game_mode = SINGLE_BALL_MODE;
+        state->arena = false;
+        reset_level(state);
+        mark_all_dirty(events);
+    }
+    // Up pressed with down held on the help screen switches to an arena
+    // (or back) instead of starting, for a new game too. Not in versus
+    // or netplay, an arena doesn't fit in a rollback snapshot.
+    if (state->screen_kind == HELP_SCREEN && (gamepad & BUTTON_DOWN) &&
+        (pressed_this_frame & BUTTON_UP)) {
+        pressed_this_frame &= (uint8_t) ~BUTTON_UP;
+        if (!state->in_progress && !state->versus && !state->netplay) {
+            state->arena = !state->arena;
+            reset_level(state);
+            mark_all_dirty(events);
+        }
+    }
+
+    // Switch Screen Logic
+    if (pressed_this_frame & BUTTON_DOWN) {
+        state->screen_kind = HELP_SCREEN;
+    }
+    if (state->screen_kind == GAME_OVER_SCREEN) {
+        if (pressed_this_frame & BUTTON_UP) {
+            state->level = next_level(state);
+            reset_level(state);
+            mark_all_dirty(events);
+            state->screen_kind = GAME_SCREEN;
+            state->in_progress = true;
+            return false;
+        }
+    } else {
+        if (pressed_this_frame & BUTTON_UP) {
+            state->screen_kind = GAME_SCREEN;
+            state->in_progress = true;
+        }
+    }
+
+    switch (state->screen_kind) {
+    case HELP_SCREEN: {
+        // The game mode is for a new game, switching it in a paused one
+        // would change its rules
+        if ((pressed_this_frame & BUTTON_2) && !state->in_progress && !state->versus &&
+            !state->netplay) {
+            state->game_mode = (state->game_mode + 1) % NUM_GAME_MODES;
+            mark_all_dirty(events);
+        }
+        // Endless mode too, a paused generated level would be left
+        // without it. Once that game is over, the next one without it
+        // starts from the level pack again.
+        if ((pressed_this_frame & BUTTON_RIGHT) && !state->in_progress) {
+            state->endless = !state->endless;
+            if (!state->endless && state->level >= NUM_LEVELS) {
+                state->level = FIRST_LEVEL;
+                reset_level(state);
+            }
+            mark_all_dirty(events);
+        }
+        break;
+    }
+    case GAME_SCREEN: {
+        if (!any_brick_alive(state)) {
+            state->screen_kind = GAME_OVER_SCREEN;
+            state->in_progress = false;
+            return false;
+        }
+        if (any_brick_crossed_or_touched_paddle(state)) {
+            state->screen_kind = GAME_OVER_SCREEN;
+            state->in_progress = false;
+            return false;
+        }
+
+        // Button Actions
+        control_paddle(state, 0, gamepad, pressed_this_frame, events);
+        if (state->versus) {
+            control_paddle(state, 1, gamepad2, pressed2, events);
+        }
+
+        // Animate and State Update
+        {
+            Ball_Pool *balls = &state->balls;
+
+            // Lower Wall, backwards since a lost ball is replaced by the
+            // last one (which was already looked at)
+            for (int i = balls->count - 1; i >= 0; i--) {
+                if (fixed_floor(balls->y[i]) + BALL_DIAMETER >= SCREEN_SIZE - 1) {
+                    mark_dirty(events, ball_rect(balls, i));
+                    if (state->versus) {
+                        rest_ball_on_paddle(state, i);
+                        mark_dirty(events, ball_rect(balls, i));
                     } else {
-                        text_y += FONT_SIZE + text_ypad;
-                        text("restart from", text_x, text_y);
-                        text_y += FONT_SIZE + text_ypad;
-                        text("the beginning!", text_x, text_y);
+                        remove_ball(balls, i);
                     }
                 }
             }
-        }
+            if (balls->count == 0) {
+                if (state->num_balls_left > 0) {
+                    reset_ball(state);
+                    mark_dirty(events, ball_rect(balls, 0));
+                    state->num_balls_left--;
+                } else {
+                    state->screen_kind = GAME_OVER_SCREEN;
+                    state->in_progress = false;
+                    return false;
+                }
+            }
 
+            // Movement and collisions, one pass over all the balls.
+            // Balls released this frame join in on the next one.
+            {
+                bool hit = false;
+                int num_balls = balls->count;
+                for (int i = 0; i < num_balls; i++) {
+                    if (balls->velocity_y[i] == 0) {
+                        continue;
+                    }
+                    Rect before = ball_rect(balls, i);
+                    hit |= step_ball(state, i, ball_player(state, i) == 0 ? gamepad : gamepad2,
+                                     events);
+                    Rect after = ball_rect(balls, i);
+                    if (!rect_equal(before, after)) {
+                        mark_dirty(events, rect_union(before, after));
+                    }
+                }
+                if (hit && events) {
+                    events->brick_hit = true;
+                }
+            }
+
+            if (!state->arena && tick_brick_fall(&state->bricks)) {
+                for (int row = 0; row < NUM_BRICK_ROWS; row++) {
+                    if (brick_row_moved(&state->bricks, row)) {
+                        // Rows fall at most a pixel per cycle
+                        Rect r = brick_row_rect(&state->bricks, row);
+                        r.y--;
+                        r.height++;
+                        mark_dirty(events, r);
+                    }
+                }
+            }
+        }
+        break;
+    }
+    case GAME_OVER_SCREEN: {
+        generate_next_level(state);
         break;
     }
     case NUM_SCREEN:
@@ -752,6 +1772,366 @@ void update() {
         panic("Unreachable!");
     }
 
-    clock_tick(&state.frame_clock);
-    state.previous_gamepad = gamepad;
+    clock_tick(&state->frame_clock);
+    state->previous_gamepad = gamepad;
+    state->previous_gamepad2 = gamepad2;
+    return true;
+}
+
+// Rollback netplay (see src/rollback.h): a versus game between peers
+// that each simulate it in a Game_State of their own, from inputs that
+// can come in late. On WASM-4 the runtime already rolls the whole cart
+// back for NETPLAY, this is for hosts that run the game themselves
+// (see native/netplay.c).
+
+// A snapshot is the state as it is in memory, minus the balls that
+// aren't in play, the level generator (derived, see Game_State) and the
+// arena (netplay has none)
+#define SNAPSHOT_HEAD_SIZE offsetof(Game_State, balls)
+#define SNAPSHOT_TAIL_SIZE (offsetof(Game_State, generator) - offsetof(Game_State, bricks))
+#define SNAPSHOT_BALL_SIZE (2 * sizeof(Fixed) + 2 * sizeof(int16_t))
+
+_Static_assert(offsetof(Game_State, bricks) > offsetof(Game_State, balls) &&
+               offsetof(Game_State, generator) > offsetof(Game_State, bricks),
+               "Snapshots expect balls, bricks and the generator in that order");
+_Static_assert(SNAPSHOT_HEAD_SIZE + sizeof(uint16_t) + SNAPSHOT_TAIL_SIZE +
+               NUM_PLAYERS * SNAPSHOT_BALL_SIZE <= ROLLBACK_SNAPSHOT_SIZE,
+               "A versus game doesn't fit in a snapshot");
+
+// Returns false if there are too many balls for a snapshot, or an
+// arena (which never fits, nor is it in one)
+bool snapshot_game_state(const Game_State *state, uint8_t *snapshot) {
+    const Ball_Pool *balls = &state->balls;
+    size_t count = balls->count;
+    if (state->arena ||
+        SNAPSHOT_HEAD_SIZE + sizeof(balls->count) + SNAPSHOT_TAIL_SIZE +
+        count * SNAPSHOT_BALL_SIZE > ROLLBACK_SNAPSHOT_SIZE) {
+        return false;
+    }
+    uint8_t *p = snapshot;
+    memcpy(p, state, SNAPSHOT_HEAD_SIZE);
+    p += SNAPSHOT_HEAD_SIZE;
+    memcpy(p, &state->bricks, SNAPSHOT_TAIL_SIZE);
+    p += SNAPSHOT_TAIL_SIZE;
+    memcpy(p, &balls->count, sizeof(balls->count));
+    p += sizeof(balls->count);
+    memcpy(p, balls->x, count * sizeof(balls->x[0]));
+    p += count * sizeof(balls->x[0]);
+    memcpy(p, balls->y, count * sizeof(balls->y[0]));
+    p += count * sizeof(balls->y[0]);
+    memcpy(p, balls->velocity_x, count * sizeof(balls->velocity_x[0]));
+    p += count * sizeof(balls->velocity_x[0]);
+    memcpy(p, balls->velocity_y, count * sizeof(balls->velocity_y[0]));
+    return true;
+}
+
+void restore_game_state(Game_State *state, const uint8_t *snapshot) {
+    Ball_Pool *balls = &state->balls;
+    const uint8_t *p = snapshot;
+    memcpy(state, p, SNAPSHOT_HEAD_SIZE);
+    p += SNAPSHOT_HEAD_SIZE;
+    memcpy(&state->bricks, p, SNAPSHOT_TAIL_SIZE);
+    p += SNAPSHOT_TAIL_SIZE;
+    memcpy(&balls->count, p, sizeof(balls->count));
+    p += sizeof(balls->count);
+    size_t count = balls->count;
+    memcpy(balls->x, p, count * sizeof(balls->x[0]));
+    p += count * sizeof(balls->x[0]);
+    memcpy(balls->y, p, count * sizeof(balls->y[0]));
+    p += count * sizeof(balls->y[0]);
+    memcpy(balls->velocity_x, p, count * sizeof(balls->velocity_x[0]));
+    p += count * sizeof(balls->velocity_x[0]);
+    memcpy(balls->velocity_y, p, count * sizeof(balls->velocity_y[0]));
+}
+
+// Snapshots and hashes a frame, then simulates it
+void netplay_step(Game_State *state, Rollback *rollback, uint32_t frame, Game_Events *events) {
+    if (!snapshot_game_state(state, rollback_snapshot(rollback, frame))) {
+        panic("The game doesn't fit in a rollback snapshot");
+    }
+    rollback->hashes[frame % ROLLBACK_HASH_FRAMES] = game_state_checksum(state);
+    uint8_t gamepad = rollback_frame_input(rollback, frame, 0);
+    uint8_t gamepad2 = rollback_frame_input(rollback, frame, 1);
+    game_step(state, gamepad, gamepad2, events);
+}
+
+// Goes back to the first frame that was simulated with a wrong guess
+// and simulates it and the ones after it again, with what came in since
+void netplay_resimulate(Game_State *state, Rollback *rollback, Game_Events *events) {
+    uint32_t frame = rollback->rollback_to;
+    if (frame == rollback->frame) {
+        return;
+    }
+    uint32_t depth = rollback->frame - frame;
+    rollback->rollbacks++;
+    rollback->resimulated += depth;
+    if (depth > rollback->max_depth) {
+        rollback->max_depth = depth;
+    }
+    restore_game_state(state, rollback_snapshot(rollback, frame));
+    for (; frame < rollback->frame; frame++) {
+        netplay_step(state, rollback, frame, events);
+    }
+    rollback->rollback_to = rollback->frame;
+    // What's on screen is of the frames that were wrong
+    mark_all_dirty(events);
+}
+
+// A frame of netplay: undoes the wrong guesses, if there are any, then
+// simulates the next frame unless that would get too far ahead of the
+// other peers. Returns false if it didn't (the game waits for them).
+bool netplay_advance(Game_State *state, Rollback *rollback, int local_player,
+                     Game_Events *events) {
+    netplay_resimulate(state, rollback, events);
+    rollback_check_hash(rollback);
+    if (!rollback_can_advance(rollback, local_player)) {
+        return false;
+    }
+    netplay_step(state, rollback, rollback->frame, events);
+    rollback->frame++;
+    rollback->rollback_to = rollback->frame;
+    return true;
+}
+
+// Bursts out of the bricks broken since the last frame, then moves the
+// particles a frame and draws them over the rest of GAME_SCREEN
+void render_particles() {
+    for (uint8_t i = 0; i < renderer.events.num_broken; i++) {
+        spawn_particle_burst(&particles, world_to_screen(renderer.events.broken[i]),
+                             PARTICLES_PER_BRICK);
+    }
+    update_particles(&particles);
+    draw_particles(&particles);
+}
+
+// Draws the frame the game is on, and plays its sounds
+void render_frame() {
+    if (renderer.events.brick_hit) {
+        // 262 Hz - 523 Hz
+        // 30 frames i.e; 0.5 sec
+        // 100% volume
+        // TONE_PULSE1
+        // tone (262, 30, 100, TONE_PULSE1);
+        // tone(262, 60, 100, TONE_PULSE1 | TONE_MODE3);
+        tone(262 | (523 << 16), 5, 25, TONE_PULSE1 | TONE_MODE1);
+        PERF_COUNT(PERF_TONES);
+    }
+
+    switch (state.screen_kind) {
+    case HELP_SCREEN:
+        render_help_screen();
+        break;
+    case GAME_SCREEN:
+        render_game_screen();
+        break;
+    case GAME_OVER_SCREEN:
+        render_game_over_screen();
+        break;
+    case NUM_SCREEN:
+    default:
+        panic("Unreachable!");
+    }
+    render_flush(&renderer.commands);
+    if (state.screen_kind == GAME_SCREEN) {
+        render_particles();
+    } else {
+        clear_particles(&particles);
+    }
+
+    renderer.screen_kind = state.screen_kind;
+    renderer.events.full_repaint = false;
+    dirty_clear(&renderer.events.dirty);
+    renderer.events.brick_hit = false;
+    renderer.events.num_broken = 0;
+}
+
+// A step of the cart's game, returns false if there's nothing new to
+// draw
+bool step_game(uint8_t gamepad, uint8_t gamepad2) {
+    Palette_Picker palette = state.current_palette;
+    bool stepped = game_step(&state, gamepad, gamepad2, &renderer.events);
+    if (state.current_palette != palette) {
+        set_palette(state.current_palette);
+    }
+    return stepped;
+}
+
+// Frames of nothing pressed on HELP_SCREEN before the demo starts,
+// and frames of demo before it goes back to HELP_SCREEN
+#define ATTRACT_IDLE_FRAMES (10 * 60)
+#define ATTRACT_DEMO_FRAMES (30 * 60)
+
+// Attract mode: the autoplayer plays the levels of the level pack in
+// turn while the help screen is left alone. The player's game is put
+// aside as a save state and comes back exactly as it was as soon as
+// a button is pressed, and the demo is neither recorded nor saved.
+typedef struct {
+    // Native tools that want the help screen to stay up turn it off
+    bool enabled;
+    bool on;
+    // Idle frames, then frames of demo
+    uint16_t frames;
+    // Played by the next demo
+    Level level;
+    uint8_t saved_state[SAVE_STATE_DISK_SIZE];
+} Attract;
+
+Attract attract = {.enabled=true};
+
+void start_attract() {
+    // Games that don't fit in a save state whole keep the help screen
+    if (!game_fits_save_state(&state) || !save_game_state(&state, attract.saved_state)) {
+        return;
+    }
+    attract.on = true;
+    attract.frames = 0;
+    state.level = attract.level;
+    attract.level = (Level) ((attract.level + 1) % NUM_LEVELS);
+    // So the generator keeps the player's level
+    state.endless = false;
+    state.versus = false;
+    state.arena = false;
+    reset_level(&state);
+    state.screen_kind = GAME_SCREEN;
+    renderer.events.full_repaint = true;
+}
+
+void stop_attract() {
+    attract.on = false;
+    attract.frames = 0;
+    if (!load_game_state(&state, attract.saved_state)) {
+        panic("Unreachable! The attract mode lost the game");
+    }
+    renderer.events.full_repaint = true;
+}
+
+// Plays the demo instead of a normal tick and returns true while it
+// is on, *stepped is what step_game() returned then. Pressing anything
+// (on either gamepad) stops it and goes on to a normal tick, so the
+// press counts on the help screen.
+bool update_attract(uint8_t gamepad, bool *stepped) {
+    if (!attract.on) {
+        bool idle = attract.enabled && !replays.playing && gamepad == 0 &&
+                    state.screen_kind == HELP_SCREEN;
+        attract.frames = idle ? (uint16_t) (attract.frames + 1) : 0;
+        if (attract.frames < ATTRACT_IDLE_FRAMES) {
+            return false;
+        }
+        start_attract();
+        if (!attract.on) {
+            attract.frames = 0;
+            return false;
+        }
+    }
+    if (gamepad != 0 || attract.frames == ATTRACT_DEMO_FRAMES) {
+        stop_attract();
+        return false;
+    }
+    attract.frames++;
+    *stepped = step_game(autoplayer_input(&state), 0);
+    return true;
+}
+
+// Turbo and slow motion are on the mouse, which the game doesn't use,
+// so they stay out of the recorded input: the left button doubles the
+// speed, the right button halves it and the middle one resets it.
+// Netplay doesn't share the mouse, so it's left alone then.
+Timestep timestep = {.scale=FIXED_ONE};
+uint8_t previous_mouse_buttons = 0;
+
+#define NETPLAY_ACTIVE 0b100
+
+void update_time_scale(uint8_t mouse_buttons) {
+    if (*NETPLAY & NETPLAY_ACTIVE) {
+        return;
+    }
+    uint8_t pressed = mouse_buttons & (mouse_buttons ^ previous_mouse_buttons);
+    previous_mouse_buttons = mouse_buttons;
+    if (pressed & MOUSE_LEFT) {
+        timestep_set_scale(&timestep, timestep.scale * 2);
+    }
+    if (pressed & MOUSE_RIGHT) {
+        timestep_set_scale(&timestep, timestep.scale / 2);
+    }
+    if (pressed & MOUSE_MIDDLE) {
+        timestep_reset(&timestep);
+    }
+}
+
+// A tick of the cart: a game_step() with everything around it (replays,
+// the attract mode, recording and saving). Returns false if there's
+// nothing new to draw.
+bool update_tick(uint8_t gamepad, uint8_t gamepad2) {
+    if (!replays.playing && state.screen_kind == HELP_SCREEN &&
+        (gamepad & ~state.previous_gamepad & BUTTON_LEFT)) {
+        play_disk_replay();
+    }
+    if (replays.playing) {
+        // Replays are of player 1 alone
+        replay_next(&replays.player, &gamepad);
+        gamepad2 = 0;
+    }
+    bool stepped;
+    if (update_attract(gamepad | gamepad2, &stepped)) {
+        return stepped;
+    }
+
+    // The checksum is of the state after the last frame it has
+    if (replays.recording_on && !replays.recording_full &&
+        !replay_append(replays.recording, recording_runs(), replays.recording_capacity,
+                       gamepad)) {
+        seal_recording();
+        replays.recording_full = true;
+    }
+
+    Screen_Kind screen_kind = state.screen_kind;
+    bool ball_was_resting = ball_resting(&state.balls);
+    stepped = step_game(gamepad, gamepad2);
+    // Replays hold GAMEPAD1 only, versus sessions aren't recorded
+    if (state.versus) {
+        replays.recording_on = false;
+    }
+
+    // Game over or paused
+    if (state.screen_kind != screen_kind &&
+        (state.screen_kind == GAME_OVER_SCREEN || state.screen_kind == HELP_SCREEN)) {
+        stack_report();
+    }
+
+    if (replays.playing) {
+        if (replays.player.run == replays.player.header->num_runs) {
+            finish_replay();
+        }
+    } else {
+        if (screen_kind != GAME_OVER_SCREEN && state.screen_kind == GAME_OVER_SCREEN) {
+            save_recording();
+        }
+        autosave(screen_kind, ball_was_resting);
+    }
+    return stepped;
+}
+
+// Runs the ticks that are due, with the buttons held this frame, then
+// draws the frame they end on. What changed piles up in
+// renderer.events over the ticks, so drawing costs the same however
+// many of them ran.
+void update() {
+    uint8_t gamepad = *GAMEPAD1;
+    uint8_t gamepad2 = *GAMEPAD2;
+    perf_dump_on_combo(gamepad2, state.previous_gamepad2);
+    update_time_scale(*MOUSE_BUTTONS);
+
+    render_begin_frame(&renderer.commands);
+    int ticks = timestep_begin_frame(&timestep);
+    bool stale = false;
+    for (int i = 0; i < ticks; i++) {
+        stale |= update_tick(gamepad, gamepad2);
+    }
+    if (stale) {
+        render_frame();
+    }
+    if (disk.changed) {
+        write_disk();
+    }
+    perf_end_frame();
 }
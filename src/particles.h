@@ -0,0 +1,163 @@
+#include "raster.h"
+#include "utils.h"
+#include "wasm4.h"
+
+#include <stdint.h>
+
+#ifndef PARTICLES_H_
+#define PARTICLES_H_
+
+// Particles: single pixels that fly off broken bricks and fall, drawn
+// straight into FRAMEBUFFER over everything else. They are only for
+// show, in screen coordinates and outside of the game state.
+//
+// A fixed-capacity pool in structure-of-arrays form over storage it is
+// given, nothing is ever allocated. Particles all live as long, so the
+// ones alive are always one stretch of the pool in the order they were
+// spawned (a ring): the oldest go first, and when the pool is full a
+// new particle takes the oldest one's slot instead of being dropped.
+
+// Positions and velocities are in 1/64 pixels
+#define PARTICLE_SHIFT     6
+#define PARTICLE_LIFETIME  32
+#define PARTICLE_GRAVITY   3
+// Storage needed per particle
+#define PARTICLE_BYTES     (2 * sizeof(int16_t) + 2 * sizeof(int8_t) + sizeof(uint8_t))
+
+typedef struct {
+    int16_t *x;
+    int16_t *y;
+    int8_t *velocity_x;
+    int8_t *velocity_y;
+    // Frames left, 0 once it's gone
+    uint8_t *life;
+    uint16_t capacity;
+    // The count slots from first on (wrapping around) are the live
+    // ones, oldest first
+    uint16_t first;
+    uint16_t count;
+    uint32_t random;
+    // Around the pixels drawn last, empty if there were none
+    Rect drawn;
+} Particle_Pool;
+
+// storage has room for capacity * PARTICLE_BYTES bytes and is aligned
+// for int16_t
+void particles_init(Particle_Pool *pool, void *storage, uint16_t capacity) {
+    pool->x = storage;
+    pool->y = pool->x + capacity;
+    pool->velocity_x = (int8_t *) (pool->y + capacity);
+    pool->velocity_y = pool->velocity_x + capacity;
+    pool->life = (uint8_t *) (pool->velocity_y + capacity);
+    pool->capacity = capacity;
+    pool->first = 0;
+    pool->count = 0;
+    pool->random = 0x2545f491u;
+    pool->drawn = (Rect) {0};
+}
+
+void clear_particles(Particle_Pool *pool) {
+    pool->first = 0;
+    pool->count = 0;
+    pool->drawn = (Rect) {0};
+}
+
+// At a pixel, velocity in 1/64 pixels per frame
+void spawn_particle(Particle_Pool *pool, int x, int y, int velocity_x, int velocity_y) {
+    if (pool->count == pool->capacity) {
+        pool->first = (uint16_t) (pool->first + 1 == pool->capacity ? 0 : pool->first + 1);
+        pool->count--;
+    }
+    int i = pool->first + pool->count;
+    if (i >= pool->capacity) {
+        i -= pool->capacity;
+    }
+    pool->count++;
+    pool->x[i] = (int16_t) (x << PARTICLE_SHIFT);
+    pool->y[i] = (int16_t) (y << PARTICLE_SHIFT);
+    pool->velocity_x[i] = (int8_t) velocity_x;
+    pool->velocity_y[i] = (int8_t) velocity_y;
+    pool->life[i] = PARTICLE_LIFETIME;
+}
+
+// Particles all over r, thrown up and to the sides
+void spawn_particle_burst(Particle_Pool *pool, Rect r, int count) {
+    for (int n = 0; n < count; n++) {
+        uint32_t random = random_next(&pool->random);
+        spawn_particle(pool,
+                       r.x + (int) ((random & 0xff) * (uint32_t) r.width >> 8),
+                       r.y + (int) (((random >> 8) & 0xff) * (uint32_t) r.height >> 8),
+                       (int) ((random >> 16) & 0x3f) - 32,
+                       -(int) ((random >> 24) & 0x3f) - 16);
+    }
+}
+
+// The view moved by -dy pixels
+void scroll_particles(Particle_Pool *pool, int dy) {
+    int i = pool->first;
+    for (int n = 0; n < pool->count; n++) {
+        pool->y[i] = (int16_t) (pool->y[i] + (dy << PARTICLE_SHIFT));
+        if (++i == pool->capacity) {
+            i = 0;
+        }
+    }
+}
+
+// Moves the particles a frame, the ones that left the screen or lived
+// their life are gone
+void update_particles(Particle_Pool *pool) {
+    const int16_t max_position = SCREEN_SIZE << PARTICLE_SHIFT;
+    int i = pool->first;
+    for (int n = 0; n < pool->count; n++) {
+        int velocity_y = pool->velocity_y[i] + PARTICLE_GRAVITY;
+        pool->velocity_y[i] = (int8_t) (velocity_y < INT8_MAX ? velocity_y : INT8_MAX);
+        pool->x[i] = (int16_t) (pool->x[i] + pool->velocity_x[i]);
+        pool->y[i] = (int16_t) (pool->y[i] + pool->velocity_y[i]);
+        if (pool->life[i] > 0) {
+            pool->life[i]--;
+        }
+        if (pool->x[i] < 0 || pool->x[i] >= max_position ||
+            pool->y[i] < 0 || pool->y[i] >= max_position) {
+            pool->life[i] = 0;
+        }
+        if (++i == pool->capacity) {
+            i = 0;
+        }
+    }
+    while (pool->count > 0 && pool->life[pool->first] == 0) {
+        pool->first = (uint16_t) (pool->first + 1 == pool->capacity ? 0 : pool->first + 1);
+        pool->count--;
+    }
+}
+
+// A pixel per particle, the darkest color fading to the next one in
+// the second half of its life
+void draw_particles(Particle_Pool *pool) {
+    int min_x = SCREEN_SIZE, min_y = SCREEN_SIZE, max_x = -1, max_y = -1;
+    uint32_t drawn = 0;
+    int i = pool->first;
+    for (int n = 0; n < pool->count; n++) {
+        uint8_t life = pool->life[i];
+        int x = pool->x[i] >> PARTICLE_SHIFT;
+        int y = pool->y[i] >> PARTICLE_SHIFT;
+        if (life > 0 && (unsigned) x < SCREEN_SIZE && (unsigned) y < SCREEN_SIZE) {
+            uint8_t color = life > PARTICLE_LIFETIME / 2 ? 3 : 2;
+            int shift = (x & 0x3) << 1;
+            raster_write_masked(&FRAMEBUFFER[y * RASTER_ROW_BYTES + (x >> 2)],
+                                (uint8_t) (color << shift), (uint8_t) (0x3 << shift));
+            if (x < min_x) min_x = x;
+            if (x > max_x) max_x = x;
+            if (y < min_y) min_y = y;
+            if (y > max_y) max_y = y;
+            drawn++;
+        }
+        if (++i == pool->capacity) {
+            i = 0;
+        }
+    }
+    W4_FRAMEBUFFER_WRITE(drawn);
+    pool->drawn = drawn > 0 ? (Rect) {min_x, min_y, max_x - min_x + 1, max_y - min_y + 1} :
+                              (Rect) {0};
+}
+
+#endif
@@ -0,0 +1,114 @@
+#include "wasm4.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#ifndef PERF_COUNTERS_H_
+#define PERF_COUNTERS_H_
+
+// DEBUG builds count how often the hot paths run in a frame and keep
+// the last PERF_FRAMES frames in a ring buffer. Holding down and
+// pressing x traces min/avg/max of each counter over those frames,
+// the native headless runner can write every frame to a CSV file.
+//
+// Without DEBUG all of it is empty macros, the release cart doesn't
+// have a single byte of it.
+
+typedef enum {
+    // sweep_ball_rect(), against walls, the paddle and bricks
+    PERF_SWEEP_TESTS,
+    // Bricks looked at by the broadphase in sweep_bricks()
+    PERF_BRICK_TESTS,
+    PERF_CLOCK_TICKS,
+    // Draws, rects and blits are rasterized in the cart (see raster.h)
+    PERF_RECTS,
+    PERF_BLITS,
+    PERF_TEXTS,
+    PERF_TONES,
+    NUM_PERF_COUNTERS
+} Perf_Counter;
+
+#ifdef DEBUG
+
+#define PERF_FRAMES 64
+
+static const char *perf_counter_names[NUM_PERF_COUNTERS] = {
+    [PERF_SWEEP_TESTS] = "sweep_tests",
+    [PERF_BRICK_TESTS] = "brick_tests",
+    [PERF_CLOCK_TICKS] = "clock_ticks",
+    [PERF_RECTS]       = "rects",
+    [PERF_BLITS]       = "blits",
+    [PERF_TEXTS]       = "texts",
+    [PERF_TONES]       = "tones",
+};
+
+typedef struct {
+    // Of the frame in progress
+    uint32_t counts[NUM_PERF_COUNTERS];
+    uint32_t samples[PERF_FRAMES][NUM_PERF_COUNTERS];
+    // Where the next frame goes
+    uint32_t next;
+    uint32_t num_samples;
+} Perf_Counters;
+
+// Native tools may step games on several threads, each counts its own
+#ifdef W4_NATIVE
+_Thread_local
+#endif
+Perf_Counters perf_counters = {0};
+
+#define PERF_COUNT(counter) (perf_counters.counts[(counter)]++)
+
+void perf_end_frame() {
+    memcpy(perf_counters.samples[perf_counters.next], perf_counters.counts,
+           sizeof(perf_counters.counts));
+    memset(perf_counters.counts, 0, sizeof(perf_counters.counts));
+    perf_counters.next = (perf_counters.next + 1) % PERF_FRAMES;
+    if (perf_counters.num_samples < PERF_FRAMES) {
+        perf_counters.num_samples++;
+    }
+}
+
+// Counts of the last frame that ended
+const uint32_t *perf_last_frame() {
+    return perf_counters.samples[(perf_counters.next + PERF_FRAMES - 1) % PERF_FRAMES];
+}
+
+void perf_dump() {
+    uint32_t n = perf_counters.num_samples;
+    if (n == 0) {
+        return;
+    }
+    tracef("Counters per frame over the last %d frames:", (int) n);
+    for (int c = 0; c < NUM_PERF_COUNTERS; c++) {
+        uint32_t min = UINT32_MAX;
+        uint32_t max = 0;
+        uint64_t sum = 0;
+        for (uint32_t i = 0; i < n; i++) {
+            uint32_t count = perf_counters.samples[i][c];
+            min = count < min ? count : min;
+            max = count > max ? count : max;
+            sum += count;
+        }
+        tracef("  %s: min %d avg %d max %d", perf_counter_names[c],
+               (int) min, (int) (sum / n), (int) max);
+    }
+}
+
+// Down held and x pressed on player 2's gamepad, buttons the game never
+// reads from player 2, so the dump doesn't change the game it measures
+void perf_dump_on_combo(uint8_t gamepad2, uint8_t previous_gamepad2) {
+    if ((gamepad2 & BUTTON_DOWN) && (gamepad2 & ~previous_gamepad2 & BUTTON_1)) {
+        perf_dump();
+    }
+}
+
+#else
+
+#define PERF_COUNT(counter)  ((void) 0)
+#define perf_end_frame()     ((void) 0)
+#define perf_dump_on_combo(gamepad2, previous_gamepad2) ((void) 0)
+
+#endif
+
+#endif
@@ -0,0 +1,201 @@
+#include "perf_counters.h"
+#include "utils.h"
+#include "wasm4.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifndef RASTER_H_
+#define RASTER_H_
+
+// Draws into FRAMEBUFFER directly instead of going through the host,
+// pixel for pixel the same as rect() and blitSub() would. Pixels are
+// 2bpp, pixel x of a row is in bits (x & 3) * 2 of byte x / 4, so a
+// horizontal span is a masked byte on each end and whole bytes in
+// between, which are written a word (or with RASTER_SIMD128, 16 bytes)
+// at a time.
+
+#define RASTER_ROW_BYTES (SCREEN_SIZE / 4)
+
+#ifdef RASTER_SIMD128
+// Lowered to v128 with -msimd128 (and to the host's vectors natively)
+typedef uint8_t Raster_Vector __attribute__((vector_size(16)));
+#endif
+
+// Sets bytes [from, to) of the framebuffer to pattern
+void raster_fill_bytes(uint8_t *from, uint8_t *to, uint8_t pattern) {
+#ifdef RASTER_SIMD128
+    if (to - from >= 16) {
+        Raster_Vector vector = (Raster_Vector) {0} + pattern;
+        for (; to - from >= 16; from += 16) {
+            memcpy(from, &vector, 16);
+        }
+    }
+#endif
+    while (from < to && ((uintptr_t) from & 0x3)) {
+        *from++ = pattern;
+    }
+    uint32_t word = pattern * 0x01010101u;
+    for (; to - from >= 4; from += 4) {
+        memcpy(from, &word, 4);
+    }
+    while (from < to) {
+        *from++ = pattern;
+    }
+}
+
+// Sets the pixels selected by mask in a byte
+void raster_write_masked(uint8_t *byte, uint8_t pattern, uint8_t mask) {
+    *byte = (uint8_t) ((*byte & ~mask) | (pattern & mask));
+}
+
+// Fills [x0, x1) on rows [y0, y1) with a palette color index (0-3),
+// the span must be on screen and not empty
+void raster_fill_span(uint8_t color, int x0, int x1, int y0, int y1) {
+    uint8_t pattern = (uint8_t) (color * 0x55);
+    uint8_t *row = FRAMEBUFFER + y0 * RASTER_ROW_BYTES;
+    int first = x0 >> 2;
+    int last = (x1 - 1) >> 2;
+    W4_FRAMEBUFFER_WRITE((uint32_t) ((last - first + 1) * (y1 - y0)));
+
+    // Whole rows are one run of bytes
+    if (x0 == 0 && x1 == SCREEN_SIZE) {
+        raster_fill_bytes(row, row + (y1 - y0) * RASTER_ROW_BYTES, pattern);
+        return;
+    }
+
+    uint8_t head = (uint8_t) (0xff << ((x0 & 0x3) << 1));
+    uint8_t tail = (uint8_t) (0xff >> ((3 - ((x1 - 1) & 0x3)) << 1));
+    if (first == last) {
+        head &= tail;
+    }
+    for (int y = y0; y < y1; y++, row += RASTER_ROW_BYTES) {
+        raster_write_masked(&row[first], pattern, head);
+        if (first != last) {
+            raster_fill_bytes(&row[first + 1], &row[last], pattern);
+            raster_write_masked(&row[last], pattern, tail);
+        }
+    }
+}
+
+// Fills the part of r on screen with a palette color index (0-3)
+void raster_fill(Rect r, uint8_t color) {
+    Rect visible = rect_intersection(r, (Rect) {0, 0, SCREEN_SIZE, SCREEN_SIZE});
+    if (rect_empty(visible)) {
+        return;
+    }
+    raster_fill_span(color, visible.x, visible.x + visible.width,
+                     visible.y, visible.y + visible.height);
+}
+
+void raster_clear(uint8_t color) {
+    raster_fill_span(color, 0, SCREEN_SIZE, 0, SCREEN_SIZE);
+}
+
+// Same as rect() with the given draw colors, r must not be empty
+void raster_rect(Rect r, uint16_t draw_colors) {
+    PERF_COUNT(PERF_RECTS);
+    uint8_t fill = draw_colors & 0xf;
+    uint8_t stroke = (draw_colors >> 4) & 0xf;
+    if (fill != 0) {
+        raster_fill(r, (uint8_t) ((fill - 1) & 0x3));
+    }
+    if (stroke != 0) {
+        uint8_t color = (uint8_t) ((stroke - 1) & 0x3);
+        raster_fill((Rect) {r.x, r.y, r.width, 1}, color);
+        raster_fill((Rect) {r.x, r.y + r.height - 1, r.width, 1}, color);
+        raster_fill((Rect) {r.x, r.y, 1, r.height}, color);
+        raster_fill((Rect) {r.x + r.width - 1, r.y, 1, r.height}, color);
+    }
+}
+
+// What a 2bpp sprite byte becomes in the framebuffer with some draw
+// colors: the pixels flipped into framebuffer order and mapped to
+// palette colors, with mask selecting the ones that aren't transparent
+typedef struct {
+    uint16_t draw_colors;
+    bool valid;
+    uint8_t pixels[256];
+    uint8_t mask[256];
+} Raster_Color_Map;
+
+void raster_set_draw_colors(Raster_Color_Map *map, uint16_t draw_colors) {
+    if (map->valid && map->draw_colors == draw_colors) {
+        return;
+    }
+    for (int byte = 0; byte < 256; byte++) {
+        uint8_t pixels = 0;
+        uint8_t mask = 0;
+        for (int i = 0; i < 4; i++) {
+            int color_index = (byte >> (6 - (i << 1))) & 0x3;
+            int dc = (draw_colors >> (color_index << 2)) & 0xf;
+            if (dc != 0) {
+                pixels |= (uint8_t) (((dc - 1) & 0x3) << (i << 1));
+                mask |= (uint8_t) (0x3 << (i << 1));
+            }
+        }
+        map->pixels[byte] = pixels;
+        map->mask[byte] = mask;
+    }
+    map->draw_colors = draw_colors;
+    map->valid = true;
+}
+
+// Same as blitSub() with the draw colors last given to map. Only 2bpp
+// sprites are drawn here, anything else goes to the host.
+void raster_blit(Raster_Color_Map *map, const uint8_t *sprite, Rect r,
+                 int src_x, int src_y, int stride, uint32_t flags) {
+    PERF_COUNT(PERF_BLITS);
+    if (flags != BLIT_2BPP) {
+        *DRAW_COLORS = map->draw_colors;
+        blitSub(sprite, r.x, r.y, (uint32_t) r.width, (uint32_t) r.height,
+                (uint32_t) src_x, (uint32_t) src_y, (uint32_t) stride, flags);
+        return;
+    }
+
+    Rect visible = rect_intersection(r, (Rect) {0, 0, SCREEN_SIZE, SCREEN_SIZE});
+    if (rect_empty(visible)) {
+        return;
+    }
+    int x0 = visible.x;
+    int x1 = visible.x + visible.width;
+    src_x += visible.x - r.x;
+    src_y += visible.y - r.y;
+    W4_FRAMEBUFFER_WRITE((uint32_t) ((((x1 - 1) >> 2) - (x0 >> 2) + 1) * visible.height));
+
+    uint8_t *row = FRAMEBUFFER + visible.y * RASTER_ROW_BYTES;
+    for (int y = 0; y < visible.height; y++, row += RASTER_ROW_BYTES) {
+        int bit_index = (src_y + y) * stride + src_x;
+        int x = x0;
+        while (x < x1) {
+            // A sprite byte that lines up with a framebuffer byte is
+            // mapped as a whole
+            if (((bit_index | x) & 0x3) == 0 && x + 4 <= x1) {
+                uint8_t byte = sprite[bit_index >> 2];
+                raster_write_masked(&row[x >> 2], map->pixels[byte], map->mask[byte]);
+                x += 4;
+                bit_index += 4;
+                continue;
+            }
+            // Otherwise the pixels going into this framebuffer byte
+            // are gathered one at a time
+            uint8_t pixels = 0;
+            uint8_t mask = 0;
+            int dst = x >> 2;
+            do {
+                int color_index = (sprite[bit_index >> 2] >> (6 - ((bit_index & 0x3) << 1))) & 0x3;
+                // The map's entry for a byte of 4 pixels of that color
+                uint8_t solid = (uint8_t) (color_index * 0x55);
+                uint8_t pixel_mask = (uint8_t) (0x3 << ((x & 0x3) << 1));
+                pixels |= map->pixels[solid] & pixel_mask;
+                mask |= map->mask[solid] & pixel_mask;
+                x++;
+                bit_index++;
+            } while (x < x1 && (x & 0x3));
+            raster_write_masked(&row[dst], pixels, mask);
+        }
+    }
+}
+
+#endif
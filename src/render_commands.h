@@ -0,0 +1,206 @@
+#include "raster.h"
+#include "utils.h"
+#include "wasm4.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifndef RENDER_COMMANDS_H_
+#define RENDER_COMMANDS_H_
+
+// Drawing is recorded into a command buffer instead of drawing right
+// away. At the end of the frame the commands are sorted by layer and
+// draw colors (stable, so recording order is kept otherwise), neighbors
+// that can be drawn as one are merged and the rest are drawn by the
+// rasterizer (see raster.h), which only has to set up a color map for
+// blits when the draw colors change.
+//
+// Within a layer, commands with different draw colors may be drawn in
+// any order, so they must not overlap. Anything that has to be drawn
+// over something else goes in a later layer.
+
+#define MAX_RENDER_COMMANDS 256
+
+typedef enum {
+    RENDER_RECT,
+    RENDER_BLIT,
+} Render_Command_Kind;
+
+typedef enum {
+    RENDER_LAYER_BACKGROUND,
+    RENDER_LAYER_SPRITES,
+    RENDER_LAYER_SHAPES,
+    // The inside of a stroked rect drawn as two fills
+    RENDER_LAYER_SHAPE_FILLS,
+    NUM_RENDER_LAYERS
+} Render_Layer;
+
+typedef struct {
+    uint8_t kind;
+    uint8_t layer;
+    uint16_t draw_colors;
+    int16_t x;
+    int16_t y;
+    uint16_t width;
+    uint16_t height;
+
+    // RENDER_BLIT only, same as blitSub()
+    const uint8_t *sprite;
+    uint16_t src_x;
+    uint16_t src_y;
+    uint16_t stride;
+    uint16_t flags;
+} Render_Command;
+
+typedef struct {
+    uint16_t commands_recorded;
+    // i.e; rasterizer calls
+    uint16_t commands_submitted;
+    uint16_t draw_colors_changes;
+} Render_Stats;
+
+typedef struct {
+    Render_Command commands[MAX_RENDER_COMMANDS];
+    uint16_t count;
+    Raster_Color_Map blit_colors;
+    // Since the last render_begin_frame()
+    Render_Stats stats;
+} Render_Buffer;
+
+void render_begin_frame(Render_Buffer *buffer) {
+    buffer->count = 0;
+    buffer->stats.commands_recorded = 0;
+    buffer->stats.commands_submitted = 0;
+    buffer->stats.draw_colors_changes = 0;
+}
+
+uint32_t render_sort_key(const Render_Command *command) {
+    return ((uint32_t) command->layer << 16) | command->draw_colors;
+}
+
+// Checks if b can be drawn as part of a (which comes right before it)
+bool render_try_merge(Render_Command *a, const Render_Command *b) {
+    if (a->kind != b->kind || a->layer != b->layer || a->draw_colors != b->draw_colors) {
+        return false;
+    }
+
+    switch (a->kind) {
+    case RENDER_RECT:
+        // A stroke goes around the whole rect, only plain fills merge
+        if (a->draw_colors & 0xf0) {
+            return false;
+        }
+        if (a->y == b->y && a->height == b->height && a->x + a->width == b->x) {
+            a->width = (uint16_t) (a->width + b->width);
+            return true;
+        }
+        if (a->x == b->x && a->width == b->width && a->y + a->height == b->y) {
+            a->height = (uint16_t) (a->height + b->height);
+            return true;
+        }
+        return false;
+    case RENDER_BLIT:
+        // Side by side both on screen and in the sprite
+        if (a->sprite == b->sprite && a->stride == b->stride && a->flags == b->flags &&
+            a->y == b->y && a->height == b->height && a->src_y == b->src_y &&
+            a->x + a->width == b->x && a->src_x + a->width == b->src_x) {
+            a->width = (uint16_t) (a->width + b->width);
+            return true;
+        }
+        return false;
+    default:
+        panicf("Unreachable! Invalid Render_Command_Kind: %d", a->kind);
+        return false;
+    }
+}
+
+// Sorts, merges and draws everything recorded so far
+void render_flush(Render_Buffer *buffer) {
+    Render_Command *commands = buffer->commands;
+    int count = buffer->count;
+
+    // Insertion sort, commands are mostly recorded in order already
+    for (int i = 1; i < count; i++) {
+        Render_Command command = commands[i];
+        uint32_t key = render_sort_key(&command);
+        int j = i;
+        while (j > 0 && render_sort_key(&commands[j - 1]) > key) {
+            commands[j] = commands[j - 1];
+            j--;
+        }
+        commands[j] = command;
+    }
+
+    int merged = 0;
+    for (int i = 0; i < count; i++) {
+        if (merged > 0 && render_try_merge(&commands[merged - 1], &commands[i])) {
+            continue;
+        }
+        commands[merged++] = commands[i];
+    }
+
+    for (int i = 0; i < merged; i++) {
+        const Render_Command *command = &commands[i];
+        if (i == 0 || command->draw_colors != commands[i - 1].draw_colors) {
+            buffer->stats.draw_colors_changes++;
+        }
+        Rect r = {command->x, command->y, command->width, command->height};
+        switch (command->kind) {
+        case RENDER_RECT:
+            raster_rect(r, command->draw_colors);
+            break;
+        case RENDER_BLIT:
+            raster_set_draw_colors(&buffer->blit_colors, command->draw_colors);
+            raster_blit(&buffer->blit_colors, command->sprite, r,
+                        command->src_x, command->src_y, command->stride, command->flags);
+            break;
+        default:
+            panicf("Unreachable! Invalid Render_Command_Kind: %d", command->kind);
+        }
+    }
+
+    buffer->stats.commands_submitted = (uint16_t) (buffer->stats.commands_submitted + merged);
+    buffer->count = 0;
+}
+
+Render_Command *render_push(Render_Buffer *buffer) {
+    if (buffer->count == MAX_RENDER_COMMANDS) {
+        // Drawing what we have keeps the order intact, there's just
+        // less to merge
+        render_flush(buffer);
+    }
+    buffer->stats.commands_recorded++;
+    return &buffer->commands[buffer->count++];
+}
+
+void render_rect(Render_Buffer *buffer, Render_Layer layer, uint16_t draw_colors, Rect r) {
+    Render_Command *command = render_push(buffer);
+    command->kind = RENDER_RECT;
+    command->layer = (uint8_t) layer;
+    command->draw_colors = draw_colors;
+    command->x = (int16_t) r.x;
+    command->y = (int16_t) r.y;
+    command->width = (uint16_t) r.width;
+    command->height = (uint16_t) r.height;
+}
+
+// Draws the part of sprite starting at (src_x, src_y) to r
+void render_blit(Render_Buffer *buffer, Render_Layer layer, uint16_t draw_colors,
+                 const uint8_t *sprite, Rect r, int src_x, int src_y, int stride,
+                 uint32_t flags) {
+    Render_Command *command = render_push(buffer);
+    command->kind = RENDER_BLIT;
+    command->layer = (uint8_t) layer;
+    command->draw_colors = draw_colors;
+    command->x = (int16_t) r.x;
+    command->y = (int16_t) r.y;
+    command->width = (uint16_t) r.width;
+    command->height = (uint16_t) r.height;
+    command->sprite = sprite;
+    command->src_x = (uint16_t) src_x;
+    command->src_y = (uint16_t) src_y;
+    command->stride = (uint16_t) stride;
+    command->flags = (uint16_t) flags;
+}
+
+#endif
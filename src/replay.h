@@ -0,0 +1,136 @@
+#include "utils.h"
+#include "wasm4.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifndef REPLAY_H_
+#define REPLAY_H_
+
+// A replay is where a session started (level, palette, game mode, the
+// seed of the generated levels and the size of its arenas) and
+// the GAMEPAD1 byte of every frame after that, run-length encoded.
+// The game is deterministic, so feeding the same bytes to update()
+// from the same start ends in the same state; the header keeps a
+// checksum of that state to catch it when it doesn't.
+//
+// The cart records into a buffer the size of its part of the disk and
+// stops when it is full, native tools can record replays of any
+// length. Both store the header followed by the runs, as is.
+
+#define REPLAY_MAGIC      0x50524242  // "BBRP"
+#define REPLAY_VERSION    4
+// Its share of the disk (see Disk_Image in main.c)
+#define REPLAY_DISK_SIZE  768
+
+typedef struct {
+    uint32_t magic;
+    uint8_t version;
+    uint8_t level;
+    uint8_t palette;
+    uint8_t game_mode;
+    uint32_t endless_seed;
+    uint16_t arena_num_bricks;
+    uint32_t num_frames;
+    // Game state checksum after the last frame
+    uint32_t checksum;
+    uint32_t num_runs;
+} Replay_Header;
+
+// `frames` frames in a row with the same buttons held
+typedef struct {
+    uint8_t frames;
+    uint8_t buttons;
+} Replay_Run;
+
+#define REPLAY_DISK_RUNS ((REPLAY_DISK_SIZE - sizeof(Replay_Header)) / sizeof(Replay_Run))
+
+// A replay that fits on the disk
+typedef struct {
+    Replay_Header header;
+    Replay_Run runs[REPLAY_DISK_RUNS];
+} Replay_Disk;
+
+_Static_assert(sizeof(Replay_Disk) <= REPLAY_DISK_SIZE, "Replay_Disk doesn't fit its part of the disk");
+
+void replay_begin(Replay_Header *header, uint8_t level, uint8_t palette, uint8_t game_mode,
+                  uint32_t endless_seed, uint16_t arena_num_bricks) {
+    header->magic = REPLAY_MAGIC;
+    header->version = REPLAY_VERSION;
+    header->level = level;
+    header->palette = palette;
+    header->game_mode = game_mode;
+    header->endless_seed = endless_seed;
+    header->arena_num_bricks = arena_num_bricks;
+    header->num_frames = 0;
+    header->checksum = 0;
+    header->num_runs = 0;
+}
+
+// Adds a frame to a replay with room for capacity runs. Returns false
+// (and leaves the replay alone) if it needs a new run and there isn't
+// room for one.
+bool replay_append(Replay_Header *header, Replay_Run *runs, uint32_t capacity, uint8_t buttons) {
+    Replay_Run *last = header->num_runs > 0 ? &runs[header->num_runs - 1] : NULL;
+    if (last && last->buttons == buttons && last->frames < UINT8_MAX) {
+        last->frames++;
+    } else {
+        if (header->num_runs == capacity) {
+            return false;
+        }
+        runs[header->num_runs].frames = 1;
+        runs[header->num_runs].buttons = buttons;
+        header->num_runs++;
+    }
+    header->num_frames++;
+    return true;
+}
+
+// Checks size bytes of replay data, the runs are right after the header
+bool replay_valid(const Replay_Header *header, uint32_t size) {
+    if (size < sizeof(Replay_Header) ||
+        header->magic != REPLAY_MAGIC || header->version != REPLAY_VERSION ||
+        header->num_runs > (size - sizeof(Replay_Header)) / sizeof(Replay_Run)) {
+        return false;
+    }
+    const Replay_Run *runs = (const Replay_Run *) (header + 1);
+    uint32_t num_frames = 0;
+    for (uint32_t i = 0; i < header->num_runs; i++) {
+        if (runs[i].frames == 0) {
+            return false;
+        }
+        num_frames += runs[i].frames;
+    }
+    return num_frames == header->num_frames;
+}
+
+typedef struct {
+    const Replay_Header *header;
+    const Replay_Run *runs;
+    uint32_t run;
+    uint8_t frame_in_run;
+} Replay_Player;
+
+void replay_play(Replay_Player *player, const Replay_Header *header, const Replay_Run *runs) {
+    player->header = header;
+    player->runs = runs;
+    player->run = 0;
+    player->frame_in_run = 0;
+}
+
+// Gives the buttons of the next frame, returns false once all of
+// them were given
+bool replay_next(Replay_Player *player, uint8_t *buttons) {
+    if (player->run == player->header->num_runs) {
+        return false;
+    }
+    const Replay_Run *run = &player->runs[player->run];
+    *buttons = run->buttons;
+    if (++player->frame_in_run == run->frames) {
+        player->run++;
+        player->frame_in_run = 0;
+    }
+    return true;
+}
+
+#endif
@@ -0,0 +1,179 @@
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifndef ROLLBACK_H_
+#define ROLLBACK_H_
+
+// Rollback netplay bookkeeping. A peer simulates a frame as soon as it
+// has its own player's input for it, guessing the inputs of the others
+// it hasn't got yet (they keep holding what they held last). When an
+// input comes in that isn't what was guessed, the game goes back to
+// its snapshot of that frame and simulates the frames since again.
+// Frames whose inputs are all in are the same on every peer, peers
+// exchange hashes of them to catch a desync.
+//
+// This keeps the inputs, snapshots and hashes of the last frames in
+// rings. What a snapshot holds and how a frame is simulated is up to
+// the game (see netplay_advance() in main.c).
+
+// Frames the game goes back at most, a peer waits for the others
+// rather than get further ahead of them than that
+#define ROLLBACK_MAX_FRAMES    8
+#define ROLLBACK_PLAYERS       2
+// Ring sizes, powers of two. Inputs can arrive ahead of the frame being
+// simulated (input delay, a peer that's ahead), hashes are compared
+// with the ones of a peer that may be behind.
+#define ROLLBACK_SNAPSHOTS     16
+#define ROLLBACK_INPUT_FRAMES  32
+#define ROLLBACK_HASH_FRAMES   64
+// Room for a snapshot of the game
+#define ROLLBACK_SNAPSHOT_SIZE 256
+
+#define ROLLBACK_NO_DESYNC     UINT32_MAX
+
+_Static_assert(ROLLBACK_SNAPSHOTS > ROLLBACK_MAX_FRAMES, "Not enough snapshots to go back");
+
+typedef struct {
+    // Next frame to simulate
+    uint32_t frame;
+    // Earliest frame simulated with a wrong guess, frame if there's none
+    uint32_t rollback_to;
+    // Frames before this have the inputs of that player
+    uint32_t confirmed[ROLLBACK_PLAYERS];
+    // Confirmed inputs, and the guesses frames were simulated with
+    uint8_t inputs[ROLLBACK_INPUT_FRAMES][ROLLBACK_PLAYERS];
+    // Of the state at the start of each frame
+    uint8_t snapshots[ROLLBACK_SNAPSHOTS][ROLLBACK_SNAPSHOT_SIZE];
+    uint32_t hashes[ROLLBACK_HASH_FRAMES];
+
+    // The newest hash from another peer, checked once that frame is
+    // confirmed here
+    bool remote_hash_pending;
+    uint32_t remote_hash_frame;
+    uint32_t remote_hash;
+    // First frame found to differ, or ROLLBACK_NO_DESYNC
+    uint32_t desync_frame;
+
+    // Stats
+    uint32_t rollbacks;
+    uint32_t resimulated;
+    uint32_t max_depth;
+} Rollback;
+
+void rollback_reset(Rollback *rollback) {
+    rollback->frame = 0;
+    rollback->rollback_to = 0;
+    for (int player = 0; player < ROLLBACK_PLAYERS; player++) {
+        rollback->confirmed[player] = 0;
+    }
+    rollback->remote_hash_pending = false;
+    rollback->desync_frame = ROLLBACK_NO_DESYNC;
+    rollback->rollbacks = 0;
+    rollback->resimulated = 0;
+    rollback->max_depth = 0;
+}
+
+// Frames before this one have every input
+uint32_t rollback_confirmed_frame(const Rollback *rollback) {
+    uint32_t frame = rollback->confirmed[0];
+    for (int player = 1; player < ROLLBACK_PLAYERS; player++) {
+        if (rollback->confirmed[player] < frame) {
+            frame = rollback->confirmed[player];
+        }
+    }
+    return frame;
+}
+
+// Adds the input of a player for a frame. They have to come in order,
+// one that's already in is ignored and one after a missing one or too
+// far ahead (no room for it) is refused: returns false then, it has to
+// be sent again.
+bool rollback_add_input(Rollback *rollback, int player, uint32_t frame, uint8_t input) {
+    if (frame < rollback->confirmed[player]) {
+        return true;
+    }
+    // Guesses are made from the input before the oldest unconfirmed one
+    if (frame != rollback->confirmed[player] ||
+        frame + 1 >= rollback_confirmed_frame(rollback) + ROLLBACK_INPUT_FRAMES) {
+        return false;
+    }
+    uint8_t *slot = &rollback->inputs[frame % ROLLBACK_INPUT_FRAMES][player];
+    if (frame < rollback->frame && *slot != input && frame < rollback->rollback_to) {
+        rollback->rollback_to = frame;
+    }
+    *slot = input;
+    rollback->confirmed[player]++;
+    return true;
+}
+
+// The input a frame is simulated with, confirmed or guessed (and the
+// guess kept, to tell whether it was right)
+uint8_t rollback_frame_input(Rollback *rollback, uint32_t frame, int player) {
+    uint8_t *slot = &rollback->inputs[frame % ROLLBACK_INPUT_FRAMES][player];
+    uint32_t confirmed = rollback->confirmed[player];
+    if (frame >= confirmed) {
+        *slot = confirmed > 0 ? rollback->inputs[(confirmed - 1) % ROLLBACK_INPUT_FRAMES][player]
+                              : 0;
+    }
+    return *slot;
+}
+
+// Whether the next frame can be simulated: it needs the input of the
+// local player, and no guess may be further back than can be undone
+bool rollback_can_advance(const Rollback *rollback, int local_player) {
+    return rollback->frame < rollback->confirmed[local_player] &&
+           rollback->frame < rollback_confirmed_frame(rollback) + ROLLBACK_MAX_FRAMES;
+}
+
+uint8_t *rollback_snapshot(Rollback *rollback, uint32_t frame) {
+    return rollback->snapshots[frame % ROLLBACK_SNAPSHOTS];
+}
+
+// Frames before this one have hashes that won't change any more: their
+// inputs are all in and they were simulated with them
+uint32_t rollback_final_frame(const Rollback *rollback) {
+    uint32_t frame = rollback_confirmed_frame(rollback) + 1;
+    return frame < rollback->rollback_to ? frame : rollback->rollback_to;
+}
+
+// The newest final frame that has a hash, returns false if there's none
+bool rollback_final_hash(const Rollback *rollback, uint32_t *frame, uint32_t *hash) {
+    uint32_t final_frame = rollback_final_frame(rollback);
+    if (final_frame == 0) {
+        return false;
+    }
+    *frame = final_frame - 1;
+    *hash = rollback->hashes[*frame % ROLLBACK_HASH_FRAMES];
+    return true;
+}
+
+void rollback_receive_hash(Rollback *rollback, uint32_t frame, uint32_t hash) {
+    if (!rollback->remote_hash_pending || frame > rollback->remote_hash_frame) {
+        rollback->remote_hash_pending = true;
+        rollback->remote_hash_frame = frame;
+        rollback->remote_hash = hash;
+    }
+}
+
+// Compares the pending hash from another peer once its frame is final
+// here, returns false on a desync
+bool rollback_check_hash(Rollback *rollback) {
+    uint32_t frame = rollback->remote_hash_frame;
+    if (!rollback->remote_hash_pending || frame >= rollback_final_frame(rollback)) {
+        return true;
+    }
+    rollback->remote_hash_pending = false;
+    // Too old, its hash is gone
+    if (frame + ROLLBACK_HASH_FRAMES <= rollback->frame) {
+        return true;
+    }
+    if (rollback->hashes[frame % ROLLBACK_HASH_FRAMES] != rollback->remote_hash) {
+        if (frame < rollback->desync_frame) {
+            rollback->desync_frame = frame;
+        }
+        return false;
+    }
+    return true;
+}
+
+#endif
@@ -0,0 +1,57 @@
+#include "bit_stream.h"
+#include "utils.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifndef SAVE_STATE_H_
+#define SAVE_STATE_H_
+
+// A save state is a header followed by the game state packed field by
+// field into as few bits as each one needs (see save_game_state() in
+// main.c). The header has a checksum of the packed bytes so anything
+// that isn't exactly what was saved is thrown away on load.
+
+#define SAVE_STATE_MAGIC     0x56534242  // "BBSV"
+#define SAVE_STATE_VERSION   4
+// Its share of the disk (see Disk_Image in main.c)
+#define SAVE_STATE_DISK_SIZE 256
+
+typedef struct {
+    uint32_t magic;
+    uint8_t version;
+    uint8_t reserved;
+    // Of the packed state after the header
+    uint16_t size;
+    uint32_t checksum;
+} Save_State_Header;
+
+#define SAVE_STATE_MAX_PACKED (SAVE_STATE_DISK_SIZE - sizeof(Save_State_Header))
+
+// Fills in the header of a save state whose packed state is size
+// bytes long
+void save_state_seal(uint8_t *save_state, uint16_t size) {
+    Save_State_Header header = {
+        .magic=SAVE_STATE_MAGIC,
+        .version=SAVE_STATE_VERSION,
+        .size=size,
+        .checksum=hash_bytes(HASH_SEED, save_state + sizeof(Save_State_Header), size),
+    };
+    memcpy(save_state, &header, sizeof(header));
+}
+
+// Checks the header of a SAVE_STATE_DISK_SIZE byte save state and the
+// checksum of what it packs, returns that size or -1 if it's not valid
+int save_state_validate(const uint8_t *save_state) {
+    Save_State_Header header;
+    memcpy(&header, save_state, sizeof(header));
+    if (header.magic != SAVE_STATE_MAGIC || header.version != SAVE_STATE_VERSION ||
+        header.size > SAVE_STATE_MAX_PACKED ||
+        header.checksum != hash_bytes(HASH_SEED, save_state + sizeof(header), header.size)) {
+        return -1;
+    }
+    return header.size;
+}
+
+#endif
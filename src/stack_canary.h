@@ -0,0 +1,50 @@
+#include "wasm4.h"
+
+#include <stdint.h>
+
+#ifndef STACK_CANARY_H_
+#define STACK_CANARY_H_
+
+// DEBUG builds of the cart fill the unused part of the stack with a
+// canary byte in start() and look for the deepest byte that isn't the
+// canary anymore to find out how much of the stack was ever used.
+//
+// The stack goes down from STACK_SIZE (it's first in memory, see the
+// Makefile) and ends where the WASM-4 framebuffer does; anything
+// deeper than that overwrites the framebuffer.
+
+#if defined(DEBUG) && !defined(W4_NATIVE)
+
+#define STACK_CANARY 0xa5
+#define STACK_LOW    ((uintptr_t) (FRAMEBUFFER + SCREEN_SIZE * SCREEN_SIZE / 4))
+
+// Everything below the caller's frame, minus some room for this call
+__attribute__((noinline)) void stack_paint() {
+    volatile uint8_t *top = (volatile uint8_t *) __builtin_frame_address(0) - 64;
+    for (volatile uint8_t *p = (volatile uint8_t *) STACK_LOW; p < top; p++) {
+        *p = STACK_CANARY;
+    }
+}
+
+// Bytes of stack used at most so far
+uint32_t stack_high_water() {
+    const volatile uint8_t *p = (const volatile uint8_t *) STACK_LOW;
+    while (p < (const volatile uint8_t *) STACK_SIZE && *p == STACK_CANARY) {
+        p++;
+    }
+    return (uint32_t) (STACK_SIZE - (uintptr_t) p);
+}
+
+void stack_report() {
+    tracef("Stack high-water mark: %d of %d bytes",
+           (int) stack_high_water(), (int) (STACK_SIZE - STACK_LOW));
+}
+
+#else
+
+#define stack_paint()  ((void) 0)
+#define stack_report() ((void) 0)
+
+#endif
+
+#endif
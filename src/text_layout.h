@@ -0,0 +1,39 @@
+#include "perf_counters.h"
+#include "wasm4.h"
+
+#include <stdint.h>
+
+#ifndef TEXT_LAYOUT_H_
+#define TEXT_LAYOUT_H_
+
+// Static screens are laid out as tables of lines, all positions are
+// known at compile time
+
+#define TEXT_X        5
+#define TEXT_Y        5
+#define TEXT_LINE_PAD 3
+
+// Top of the nth line of a screen (blank lines count)
+#define TEXT_LINE_Y(n) (TEXT_Y + (n) * (FONT_SIZE + TEXT_LINE_PAD))
+
+typedef struct {
+    const char *text;
+    uint8_t x;
+    uint8_t y;
+    uint16_t draw_colors;
+} Text_Line;
+
+#define TEXT_LINE(n, colors, str) {.text=(str), .x=TEXT_X, .y=TEXT_LINE_Y(n), .draw_colors=(colors)}
+
+// DRAW_COLORS is only written when it changes from one line to the next
+void draw_text_lines(const Text_Line *lines, int count) {
+    for (int i = 0; i < count; i++) {
+        if (i == 0 || lines[i].draw_colors != lines[i - 1].draw_colors) {
+            *DRAW_COLORS = lines[i].draw_colors;
+        }
+        text(lines[i].text, lines[i].x, lines[i].y);
+        PERF_COUNT(PERF_TEXTS);
+    }
+}
+
+#endif
@@ -0,0 +1,67 @@
+#include "utils.h"
+
+#include <stdint.h>
+
+#ifndef TIMESTEP_H_
+#define TIMESTEP_H_
+
+// Fixed timestep: the game is simulated in ticks of 1/60 s whatever the
+// rendering does, and each rendered frame runs the ticks that are due
+// by then, 0 to MAX_TICKS_PER_FRAME of them. At a scale of FIXED_ONE
+// that's one tick per frame, as WASM-4 calls update() at 60 Hz; more
+// is turbo, less is slow motion.
+//
+// WASM-4 gives the cart no clock, so the cart can't tell when the host
+// dropped frames and never catches up on its own. A host that knows
+// (the headless runner's --drop) calls timestep_catch_up() to have the
+// missed ticks made up on the next frames.
+//
+// A tick is the same whether it runs on its own or with others in a
+// frame, so the game ends up in the same state at any speed.
+
+#define MAX_TICKS_PER_FRAME 8
+#define MIN_TIME_SCALE      (FIXED_ONE / 8)
+#define MAX_TIME_SCALE      (MAX_TICKS_PER_FRAME * FIXED_ONE)
+// Ticks owed past this are dropped, so a host that can't keep up
+// slows the game down instead of falling further and further behind
+#define MAX_TICK_BACKLOG    60
+
+typedef struct {
+    // Ticks per frame
+    Fixed scale;
+    // Ticks due, the fraction of one is carried to the next frame
+    Fixed due;
+} Timestep;
+
+void timestep_reset(Timestep *timestep) {
+    timestep->scale = FIXED_ONE;
+    timestep->due = 0;
+}
+
+void timestep_set_scale(Timestep *timestep, Fixed scale) {
+    timestep->scale = clamp_int(scale, MIN_TIME_SCALE, MAX_TIME_SCALE);
+}
+
+void timestep_owe(Timestep *timestep, Fixed ticks) {
+    timestep->due = clamp_int(timestep->due + ticks, 0, int_to_fixed(MAX_TICK_BACKLOG));
+}
+
+// The host skipped update() for a number of frames, only the host can
+// tell (see above)
+void timestep_catch_up(Timestep *timestep, uint32_t frames) {
+    uint32_t most = MAX_TICK_BACKLOG;
+    timestep_owe(timestep, (Fixed) (frames < most ? frames : most) * timestep->scale);
+}
+
+// How many ticks the frame that's starting runs
+int timestep_begin_frame(Timestep *timestep) {
+    timestep_owe(timestep, timestep->scale);
+    int ticks = fixed_floor(timestep->due);
+    if (ticks > MAX_TICKS_PER_FRAME) {
+        ticks = MAX_TICKS_PER_FRAME;
+    }
+    timestep->due -= int_to_fixed(ticks);
+    return ticks;
+}
+
+#endif
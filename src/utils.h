@@ -1,3 +1,4 @@
+#include "perf_counters.h"
 #include "wasm4.h"
 #include <stdbool.h>
 
@@ -18,19 +19,28 @@ void clock_reset(Clock *clock) {
 }
 
 void clock_tick(Clock *clock) {
+    PERF_COUNT(PERF_CLOCK_TICKS);
     if (clock->clock_size == 0) {
         return;
     }
-    clock->clock = (clock->clock + 1) % clock->clock_size;
+    clock->clock = (uint16_t) ((clock->clock + 1) % clock->clock_size);
     if (clock->clock == 0) {
         clock->cycled = true;
     }
 }
 
+#ifdef W4_NATIVE
+// On the native host a panic must actually stop the process
+#include <stdlib.h>
+#define PANIC_HALT() abort()
+#else
+#define PANIC_HALT() __builtin_unreachable()
+#endif
+
 #define panicf(msg_fmt, ...) do {                              \
     tracef("PANIC: Fatal Error At %s:%d", __FILE__, __LINE__); \
     tracef(msg_fmt, ##__VA_ARGS__);                            \
-    __builtin_unreachable();                                   \
+    PANIC_HALT();                                              \
 } while(0)
 
 #define panic(msg) panicf("%s", msg)
@@ -46,6 +56,71 @@ int clamp_int(int x, int min_x, int max_x) {
     return x;
 }
 
+int abs_int(int x) {
+    return x < 0 ? -x : x;
+}
+
+// Rounds towards negative infinity (unlike `/`), d must be positive
+int floor_div(int n, int d) {
+    int q = n / d;
+    return (n % d < 0) ? q - 1 : q;
+}
+
+// Fixed point numbers with 8 fractional bits, used for sub-pixel
+// positions and velocities
+typedef int32_t Fixed;
+
+#define FIXED_SHIFT 8
+#define FIXED_ONE   (1 << FIXED_SHIFT)
+
+Fixed int_to_fixed(int n) {
+    return (Fixed) n * FIXED_ONE;
+}
+
+// Rounds towards negative infinity, i.e; the pixel a position is in
+int fixed_floor(Fixed f) {
+    return f >> FIXED_SHIFT;
+}
+
+int fixed_ceil(Fixed f) {
+    return (f + FIXED_ONE - 1) >> FIXED_SHIFT;
+}
+
+Fixed fixed_mul(Fixed a, Fixed b) {
+    return (Fixed) (((int64_t) a * b) >> FIXED_SHIFT);
+}
+
+Fixed fixed_div(Fixed a, Fixed b) {
+    return (Fixed) (((int64_t) a * FIXED_ONE) / b);
+}
+
+// FNV-1a, feed it HASH_SEED first and the previous result after that
+#define HASH_SEED 2166136261u
+
+uint32_t hash_bytes(uint32_t hash, const void *data, uint32_t size) {
+    const uint8_t *bytes = data;
+    for (uint32_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+// xorshift32, integer only so a seed gives the same numbers on every
+// build. The state must not be 0.
+uint32_t random_next(uint32_t *state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+// In [0, n)
+uint32_t random_below(uint32_t *state, uint32_t n) {
+    return (uint32_t) (((uint64_t) random_next(state) * n) >> 32);
+}
+
 // Checks if two lines are overlapping
 // Case 1:
 // l1 ----- h1
@@ -58,6 +133,48 @@ bool overlap(int l1, int h1, int l2, int h2) {
     return (l1 <= h2) && (l2 <= h1);
 }
 
+typedef struct {
+    int x;
+    int y;
+    int width;
+    int height;
+} Rect;
+
+bool rect_equal(Rect a, Rect b) {
+    return a.x == b.x && a.y == b.y && a.width == b.width && a.height == b.height;
+}
+
+bool rect_empty(Rect r) {
+    return r.width <= 0 || r.height <= 0;
+}
+
+// Checks if a lies completely inside b
+bool rect_contains(Rect b, Rect a) {
+    return a.x >= b.x && a.y >= b.y &&
+           a.x + a.width <= b.x + b.width &&
+           a.y + a.height <= b.y + b.height;
+}
+
+// Pixels covered by both a and b (empty if they don't share any)
+Rect rect_intersection(Rect a, Rect b) {
+    int x0 = a.x > b.x ? a.x : b.x;
+    int y0 = a.y > b.y ? a.y : b.y;
+    int x1 = (a.x + a.width) < (b.x + b.width) ? (a.x + a.width) : (b.x + b.width);
+    int y1 = (a.y + a.height) < (b.y + b.height) ? (a.y + a.height) : (b.y + b.height);
+    Rect r = {.x=x0, .y=y0, .width=x1 - x0, .height=y1 - y0};
+    return r;
+}
+
+// Smallest rect covering both a and b
+Rect rect_union(Rect a, Rect b) {
+    int x0 = a.x < b.x ? a.x : b.x;
+    int y0 = a.y < b.y ? a.y : b.y;
+    int x1 = (a.x + a.width) > (b.x + b.width) ? (a.x + a.width) : (b.x + b.width);
+    int y1 = (a.y + a.height) > (b.y + b.height) ? (a.y + a.height) : (b.y + b.height);
+    Rect r = {.x=x0, .y=y0, .width=x1 - x0, .height=y1 - y0};
+    return r;
+}
+
 // A lightweight custom function to reverse a string
 void reverse(char* str, int length) {
     int start = 0;
@@ -5,8 +5,20 @@
 
 #include <stdint.h>
 
+#ifdef W4_NATIVE
+// Native host build: imports are plain functions provided by
+// native/w4_runtime.c and memory lives in a host-side array.
+#define WASM_EXPORT(name)
+#define WASM_IMPORT(name)
+extern uint8_t w4_memory[65536];
+// Lets the runtime account for framebuffer bytes the cart writes itself
+void w4_note_framebuffer_write(uint32_t bytes);
+#define W4_FRAMEBUFFER_WRITE(bytes) w4_note_framebuffer_write(bytes)
+#else
 #define WASM_EXPORT(name) __attribute__((export_name(name)))
 #define WASM_IMPORT(name) __attribute__((import_name(name)))
+#define W4_FRAMEBUFFER_WRITE(bytes) ((void) 0)
+#endif
 
 WASM_EXPORT("start") void start ();
 WASM_EXPORT("update") void update ();
@@ -26,6 +38,20 @@ WASM_EXPORT("update") void update ();
 // │                                                                           │
 // └───────────────────────────────────────────────────────────────────────────┘
 
+#ifdef W4_NATIVE
+#define PALETTE ((uint32_t*)(w4_memory + 0x04))
+#define DRAW_COLORS ((uint16_t*)(w4_memory + 0x14))
+#define GAMEPAD1 ((const uint8_t*)(w4_memory + 0x16))
+#define GAMEPAD2 ((const uint8_t*)(w4_memory + 0x17))
+#define GAMEPAD3 ((const uint8_t*)(w4_memory + 0x18))
+#define GAMEPAD4 ((const uint8_t*)(w4_memory + 0x19))
+#define MOUSE_X ((const int16_t*)(w4_memory + 0x1a))
+#define MOUSE_Y ((const int16_t*)(w4_memory + 0x1c))
+#define MOUSE_BUTTONS ((const uint8_t*)(w4_memory + 0x1e))
+#define SYSTEM_FLAGS ((uint8_t*)(w4_memory + 0x1f))
+#define NETPLAY ((const uint8_t*)(w4_memory + 0x20))
+#define FRAMEBUFFER ((uint8_t*)(w4_memory + 0xa0))
+#else
 #define PALETTE ((uint32_t*)0x04)
 #define DRAW_COLORS ((uint16_t*)0x14)
 #define GAMEPAD1 ((const uint8_t*)0x16)
@@ -38,6 +64,7 @@ WASM_EXPORT("update") void update ();
 #define SYSTEM_FLAGS ((uint8_t*)0x1f)
 #define NETPLAY ((const uint8_t*)0x20)
 #define FRAMEBUFFER ((uint8_t*)0xa0)
+#endif
 
 #define BUTTON_1 1
 #define BUTTON_2 2